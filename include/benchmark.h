@@ -0,0 +1,12 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Cycle counts of the hot paths, only built into the benchmark environment (-DDRYBOX_BENCHMARK)
+#define BENCHMARK_RUNS 8
+
+#ifdef DRYBOX_BENCHMARK
+// Runs every benchmark and prints one JSON line per result over Serial
+void runBenchmarks();
+#endif
+
+#endif // BENCHMARK_H
\ No newline at end of file
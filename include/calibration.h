@@ -0,0 +1,48 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <stdint.h>
+
+#define CALIBRATION_GAIN_SHIFT 14                          // Gain is fixed point with 14 fractional bits
+#define CALIBRATION_UNITY (1 << CALIBRATION_GAIN_SHIFT)
+#define CALIBRATION_MIN_GAIN (CALIBRATION_UNITY * 4 / 5)   // 0.8, a DHT20 that is further off is broken
+#define CALIBRATION_MAX_GAIN (CALIBRATION_UNITY * 5 / 4)   // 1.25
+#define CALIBRATION_MAX_OFFSET 1000                        // 10.00 C or %
+#define CALIBRATION_MIN_SPAN 500                           // Two reference points closer than 5.00 give no usable gain
+
+// Reference humidities of saturated salt solutions at 25 C, for the guided humidity calibration
+struct SaltReference
+{
+    const char *name;
+    int16_t humidity; // 0.01 %
+};
+
+#define SALT_REFERENCE_COUNT 4
+extern const SaltReference saltReferences[SALT_REFERENCE_COUNT];
+
+// Linear transfer function from a raw reading to the calibrated value, both in 0.01 C or 0.01 %.
+// Worked out once from the reference points so applying it is one integer multiply, shift and add.
+// Stored in EEPROM in the 4 bytes the offset-only calibration used.
+struct Calibration
+{
+    int16_t gain = CALIBRATION_UNITY;
+    int16_t offset = 0;
+};
+
+inline int16_t calibrationApply(const Calibration &calibration, int16_t raw)
+{
+    return ((int32_t)raw * calibration.gain >> CALIBRATION_GAIN_SHIFT) + calibration.offset;
+}
+
+bool calibrationValid(const Calibration &calibration);
+
+// Offset only, from one reference point
+bool calibrationFromPoint(Calibration &calibration, int16_t raw, int16_t reference);
+
+// Gain and offset through two reference points, returns false if the points are too close or the result is implausible
+bool calibrationFromPoints(Calibration &calibration, int16_t raw1, int16_t reference1, int16_t raw2, int16_t reference2);
+
+// Loads a calibration, an offset stored by older firmware is taken over and anything invalid gives the identity
+void calibrationLoad(int address, Calibration &calibration);
+
+#endif // CALIBRATION_H
\ No newline at end of file
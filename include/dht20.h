@@ -0,0 +1,33 @@
+#ifndef DHT20_H
+#define DHT20_H
+
+#include <DFRobot_DHT20.h>
+
+#include "zone.h"
+
+#define TCA9548A_ADDRESS 0x70 // I2C multiplexer placing every DHT20 on its own channel
+#define NO_MUX_CHANNEL 0xFF   // Sensor is directly on the bus
+
+#define DHT20_ADDRESS 0x38
+#define DHT20_MEASURE_TIME 80          // ms from triggering a measurement until the result can be read
+#define DHT20_STATUS_BUSY 0x80         // Measurement still running
+#define DHT20_STATUS_CALIBRATED 0x08   // Calibration coefficients loaded, readings are meaningless without
+
+// DHT20 of a zone, behind its own multiplexer channel when there is more than one zone.
+// The library only brings the sensor up, measurements are read here so a failed transfer, a busy or
+// uncalibrated sensor and a corrupted frame are all reported as a failed read instead of as a reading.
+class Dht20ZoneSensor : public ZoneSensor
+{
+private:
+    DFRobot_DHT20 *dht20 = nullptr;
+    uint8_t muxChannel = NO_MUX_CHANNEL;
+
+    bool select();
+
+public:
+    void attach(DFRobot_DHT20 *dht20, uint8_t muxChannel);
+    bool begin() override;
+    bool read(float &temperature, float &humidity) override;
+};
+
+#endif // DHT20_H
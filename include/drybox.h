@@ -4,6 +4,7 @@
 #include <DFRobot_DHT20.h>
 
 #include "menu.h"
+#include "zone.h"
 
 enum DeviceState {
     MainScreen,
@@ -12,7 +13,8 @@ enum DeviceState {
     SetTargetTemp,
     SetTargetHumidity,
     SetTemperatureCalibration,
-    SetHumidityCalibration
+    SetHumidityCalibration,
+    Diagnostics
 };
 
 enum TemperatureUnit : char {
@@ -30,22 +32,24 @@ extern DFRobot_DHT20 dht20;
 
 extern unsigned long currentTime;
 
-// Temperature internally is always represented as Celsius, but can be displayed in Fahrenheit if defined.
-extern float Temperature;
-extern float Humidity;
-extern float TargetTemp;
-extern unsigned short TargetHumidity;
-extern float TemperatureCalibration; // Calibration offset for temperature
-extern float HumidityCalibration; // Calibration offset for humidity
+extern Zone zones[ZONE_COUNT];
+extern uint8_t activeZone; // Zone shown on the screen and edited by the menus
 extern TemperatureUnit Unit;
 
 extern ButtonPress onOffButtonPress;
 extern ButtonPress upButtonPress;
 extern ButtonPress downButtonPress;
 
-extern bool heaterOn;
-extern bool heaterRunning;
 extern DeviceState deviceState;
 extern MenuOption* menu;
 
+void toggleHeater(Zone &zone);
+void sampleAllZones(unsigned long time);
+void loopPass(unsigned long now, bool onOff, bool up, bool down);
+
+#ifdef DRYBOX_BENCHMARK
+// Backdates the last sensor read and redraw, so the next loop pass at now reads a zone, updates its heater and redraws
+void loopMakeDue(unsigned long now);
+#endif
+
 #endif // DRYBOX_H
\ No newline at end of file
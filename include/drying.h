@@ -0,0 +1,27 @@
+#ifndef DRYING_H
+#define DRYING_H
+
+#include <Arduino.h>
+
+#define DRYING_POINT_INTERVAL 60000UL // The fit takes one point a minute, whatever the sensor interval
+#define DRYING_DECAY_SHIFT 4          // Older points lose 1/16 of their weight per point, the fit follows the last ~15 minutes
+#define DRYING_MIN_POINTS 10          // Points needed before a projection is shown
+#define DRYING_MAX_GAP 60             // Points without a reading after which the fit starts over
+#define DRYING_STALL_RATE 1.0         // % per hour, falling slower than this above the target is a stall
+#define DRYING_MAX_ETA 5999           // Minutes, longer projections are shown as this
+
+enum DryingState : uint8_t
+{
+    DryingUnknown,  // Not enough points yet or the humidity is rising
+    DryingDone,     // Humidity is at or below the target
+    DryingProgress, // Humidity is falling, minutes to the target are projected
+    DryingStalled   // Humidity above the target falls slower than DRYING_STALL_RATE, the desiccant is saturated
+};
+
+// Feeds a calibrated humidity reading of a zone, O(1) and no history is stored
+void dryingSample(uint8_t zone, float humidity, unsigned long currentTime);
+
+// Projects when the humidity of a zone reaches the target from the fitted slope
+DryingState dryingEstimate(uint8_t zone, uint16_t targetHumidity, uint16_t &minutes);
+
+#endif // DRYING_H
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef HEATER_H
+#define HEATER_H
+
+#include <Arduino.h>
+
+// Heater outputs are switched from the interlock interrupt in a 4 s time-proportional window, so their timing does
+// not depend on the main loop. In PWM mode pin 9 (OC1A) and pin 10 (OC1B) are driven by Timer1 in hardware instead,
+// other pins stay time-proportioned so the duty limit and the soft start apply to them as well.
+#define HEATER_DRIVE_TIME_PROPORTIONAL 0 // 4 s window for relays and SSRs
+#define HEATER_DRIVE_PWM 1               // 1 kHz PWM for MOSFET heaters
+
+#ifndef HEATER_DRIVE_MODE
+#define HEATER_DRIVE_MODE HEATER_DRIVE_TIME_PROPORTIONAL
+#endif
+
+// Upper limit of the heater duty in percent, for supplies that cannot deliver the full heater power
+#ifndef HEATER_DUTY_MAX
+#define HEATER_DUTY_MAX 100
+#endif
+
+// Time for the duty to ramp from 0 up to its target after switching on, limits inrush, 0 disables
+#ifndef HEATER_SOFT_START_MS
+#define HEATER_SOFT_START_MS 5000
+#endif
+
+#define HEATER_FULL_DUTY ((uint8_t)(HEATER_DUTY_MAX * 255UL / 100))
+
+// Takes Timer1 over for the heater pins in PWM mode, call before interlockInit
+void heaterDriverInit();
+
+// Requests a duty (0-255) for a zone's heater, limited to HEATER_FULL_DUTY and applied by heaterDriverTick
+void heaterDrive(uint8_t zone, uint8_t duty);
+
+// Current ramped duty of a zone's heater
+uint8_t heaterDuty(uint8_t zone);
+
+// Interrupt context only: ramps the duty of every zone and updates the outputs
+void heaterDriverTick();
+
+// Interrupt context only: switches a zone's heater off at once
+void heaterForceOff(uint8_t zone);
+
+#endif // HEATER_H
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef INTERLOCK_H
+#define INTERLOCK_H
+
+#include <Arduino.h>
+
+// Heater safety interlock running from the Timer2 compare interrupt, independent of loop().
+// The loop delivers samples and feeds it, the interrupt forces the heater pins low on any fault
+// and also drives the heater outputs (heaterDriverTick).
+#define INTERLOCK_TICK_MS 10
+
+#define ABSOLUTE_MAX_TEMP 70.0         // Heater is cut off above this temperature no matter the target
+#define SENSOR_STALE_TIMEOUT 30000     // Heater is cut off when a zone got no sample for this many ms
+#define LOOP_STALL_TIMEOUT 1000        // Heaters are cut off when loop() did not run for this many ms, the watchdog resets at 2 s
+#define RUNAWAY_HEATING_WINDOW 900000UL // Running heater has to raise the temperature by RUNAWAY_MIN_RISE within this many ms
+#define RUNAWAY_MIN_RISE 1.0
+#define RUNAWAY_WATCH_MARGIN 3.0       // The rise is only checked this far or more below the switch on point
+#define RUNAWAY_DROP_WINDOW 300000UL   // Heating but fallen out of the band, the rise has to come within this many ms
+#define RUNAWAY_COOLING_RISE 5.0       // Rise within RUNAWAY_HEATING_WINDOW while the heater is off that means it is stuck on
+
+enum InterlockFault : uint8_t {
+    FaultOverTemperature = 1,
+    FaultStaleSensor = 2,
+    FaultRunawayHeating = 4, // Heater on far below the target but the temperature does not rise
+    FaultRunawayCooling = 8, // Heater off but the temperature keeps rising
+    FaultLoopStall = 16
+};
+
+// Starts the interrupt and the watchdog, call at the end of setup()
+void interlockInit();
+
+// Called every loop pass, proves the loop is alive and feeds the watchdog
+void interlockKick();
+
+// Hands a zone's sample and the heater state it was taken under to the interlock, call before toggleHeater.
+// The runaway watch works on the calibrated temperature, the absolute cutoff on the higher of the calibrated and
+// the raw reading, so no calibration can lift the cutoff.
+void interlockSample(uint8_t zone, float temperature, float rawTemperature, bool heaterRunning,
+                     unsigned long currentTime);
+
+uint8_t interlockFaults(uint8_t zone);
+
+// Clears the latched faults of a zone once the user switches its heater on again
+void interlockClear(uint8_t zone);
+
+// Short text for the most severe fault, for the screen
+const __FlashStringHelper *interlockFaultName(uint8_t faults);
+
+#endif // INTERLOCK_H
\ No newline at end of file
@@ -3,9 +3,12 @@
 
 #include <Arduino.h>
 #include "drybox.h"
+#include "calibration.h"
 
 enum TemperatureUnit : char;
 
+#define ZONE_CYCLE_TIME 4000 // How long each zone is shown on the main screen
+
 class MenuOption
 {
 public:
@@ -34,6 +37,12 @@ public:
         Serial.println(F("Generic down button action"));
     }
 
+    // Advances what changes on its own every loop pass, returns true if that needs a redraw
+    virtual bool tick()
+    {
+        return false;
+    }
+
     virtual void render()
     {
         Serial.println(F("Rendering generic menu option"));
@@ -44,12 +53,14 @@ class MainScreenMenu : public MenuOption
 {
 private:
     unsigned long tempSetTime = 0;
+    unsigned long zoneShownTime = 0; // When the currently shown zone came up
 
 public:
     void onOffShortPress() override;
     void onOffLongPress() override;
     void upPress() override;
     void downPress() override;
+    bool tick() override;
     void render() override;
 };
 
@@ -83,7 +94,7 @@ public:
 class SetTargetTempMenu : public MenuOption
 {
 private:
-    unsigned short targetTemp = 90; // Internal state to not affect the global TargetTemp variable directly
+    unsigned short targetTemp = 90; // Internal state to not affect the target temperature of the zone directly
 public:
     void enter() override;
     void onOffShortPress() override;
@@ -96,7 +107,7 @@ public:
 class SetTargetHumidityMenu : public MenuOption
 {
 private:
-    unsigned short targetHumidity = 50; // Internal state to not affect the global TargetHumidity variable directly
+    unsigned short targetHumidity = 50; // Internal state to not affect the target humidity of the zone directly
 public:
     void enter() override;
     void onOffShortPress() override;
@@ -106,30 +117,51 @@ public:
     // void render() override;
 };
 
-class SetTemperatureCalibrationMenu : public MenuOption
+enum CalibrationStep : uint8_t
+{
+    CalibrationFirstPoint,
+    CalibrationSecondPoint,
+    CalibrationConfirm
+};
+
+// Guided two-point calibration: the sensor is brought to two known references in turn and the line through both is saved.
+// Humidity references are saturated salt solutions, temperature references are read off a reference thermometer.
+// A long press at the second point saves an offset from the first point only.
+class CalibrationMenu : public MenuOption
 {
 private:
-    float temperatureCalibration = 0.0; // Internal state to not affect the global TemperatureCalibration variable directly
+    bool humidity; // Calibrates humidity instead of temperature
+    CalibrationStep step = CalibrationFirstPoint;
+    int16_t reference = 0; // Reference value of the current point, 0.01 C or %
+    uint8_t salt = 0;      // Salt solution picked for the current point
+    int16_t firstRaw = 0;  // Sensor reading taken at the first point
+    int16_t firstReference = 0;
+    bool failed = false;   // Points give no plausible calibration
+    Calibration result;    // Internal state to not affect the calibration of the zone before it is confirmed
+
+    int16_t rawReading();
+    void startPoint();
+    void exit();
+
 public:
+    CalibrationMenu(bool humidity) : humidity(humidity) {}
     void enter() override;
     void onOffShortPress() override;
-    // void onOffLongPress() override;
+    void onOffLongPress() override;
     void upPress() override;
     void downPress() override;
-    // void render() override;
+    void render() override;
 };
 
-class SetHumidityCalibrationMenu : public MenuOption
+class DiagnosticsMenu : public MenuOption
 {
-private:
-    float humidityCalibration = 0.0; // Internal state to not affect the global HumidityCalibration variable directly
 public:
     void enter() override;
     void onOffShortPress() override;
-    // void onOffLongPress() override;
+    void onOffLongPress() override;
     void upPress() override;
     void downPress() override;
-    // void render() override;
+    void render() override;
 };
 
 extern MainScreenMenu mainScreenMenu;
@@ -137,7 +169,8 @@ extern MainSettingsMenu mainMenu;
 extern PickTemperatureDisplayMenu pickTemperatureDisplayMenu;
 extern SetTargetTempMenu setTargetTempMenu;
 extern SetTargetHumidityMenu setTargetHumidityMenu;
-extern SetTemperatureCalibrationMenu setTemperatureCalibrationMenu;
-extern SetHumidityCalibrationMenu setHumidityCalibrationMenu;
+extern CalibrationMenu setTemperatureCalibrationMenu;
+extern CalibrationMenu setHumidityCalibrationMenu;
+extern DiagnosticsMenu diagnosticsMenu;
 
 #endif // MENU_H
\ No newline at end of file
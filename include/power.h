@@ -0,0 +1,48 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+
+// Inactivity periods (in ms) after which the display is dimmed and then switched off.
+// Both can be overridden from build_flags, 0 disables the step.
+#ifndef DISPLAY_DIM_TIMEOUT
+#define DISPLAY_DIM_TIMEOUT 60000UL
+#endif
+
+#ifndef DISPLAY_OFF_TIMEOUT
+#define DISPLAY_OFF_TIMEOUT 300000UL
+#endif
+
+// The screen is redrawn after a button press, a sensor reading, a menu change or the next zone coming up. What
+// changes on its own (faults, diagnostics) is picked up by a redraw at least this often, in ms.
+#ifndef DISPLAY_REFRESH_INTERVAL
+#define DISPLAY_REFRESH_INTERVAL 1000UL
+#endif
+
+enum DisplayPower {
+    DisplayAwake,
+    DisplayDimmed,
+    DisplayOff
+};
+
+extern DisplayPower displayPower;
+
+// Gate the clocks of unused peripherals and prepare sleep
+void powerInit();
+
+// Let a button pin wake the MCU from idle sleep through its pin change interrupt
+void wakeOnPin(uint8_t pin);
+
+// Sleep in idle mode until wakeTime (millis) or until a button changes state
+void idleUntil(unsigned long wakeTime);
+
+// Sleep in idle mode for a fixed time, for waits that buttons must not cut short
+void idleFor(unsigned long ms);
+
+// Register user activity, returns true if the display was dimmed or off and had to be woken up
+bool displayWake(unsigned long currentTime);
+
+// Dim and then switch off the display once the inactivity timeouts have passed
+void displayIdleUpdate(unsigned long currentTime);
+
+#endif // POWER_H
\ No newline at end of file
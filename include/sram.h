@@ -0,0 +1,28 @@
+#ifndef SRAM_H
+#define SRAM_H
+
+#include <Arduino.h>
+
+#define STACK_CANARY 0xC5           // Pattern painted between heap and stack at boot
+#define MEMORY_CHECK_INTERVAL 5000  // How often the stack is scanned for its high-water mark
+#define MEMORY_REPORT_INTERVAL 60000
+#define MEMORY_ALARM_THRESHOLD 64   // Heaters are switched off when the untouched gap falls below this many bytes
+
+struct MemoryStats
+{
+    uint16_t freeNow;     // Bytes between the heap break and the stack pointer
+    uint16_t freeMinimum; // Bytes between the heap break and the deepest stack use so far
+    uint16_t heapUsed;    // Bytes below the heap break
+    uint16_t stackPeak;   // Deepest stack use so far
+};
+
+extern MemoryStats memoryStats;
+extern bool memoryAlarm; // Latched until reset once the free memory ran low
+
+// Scans for the stack high-water mark and updates memoryStats and memoryAlarm
+void memoryCheck();
+
+// Periodic memoryCheck and serial report, returns true when the alarm has just been raised
+bool maybeCheckMemory(unsigned long currentTime);
+
+#endif // SRAM_H
\ No newline at end of file
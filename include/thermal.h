@@ -0,0 +1,44 @@
+#ifndef THERMAL_H
+#define THERMAL_H
+
+#include <stdint.h>
+
+#define THERMAL_MODEL_MAGIC 0xA9        // Marks a valid model in EEPROM, changes with the layout
+#define THERMAL_EEPROM_BASE 160         // Models of all zones follow the zone settings
+#define THERMAL_SAVE_INTERVAL 3600000UL // Learned models are written to EEPROM at most hourly
+#define THERMAL_MIN_CYCLES 2            // Heater cycles observed before predictions are used
+#define THERMAL_SETTLE_MARGIN 0.2       // Reversal that marks the peak or trough after a switch as found
+#define THERMAL_MAX_LEAD 5.0            // Sanity limit for learned overshoot and undershoot
+#define THERMAL_MIN_SWITCH_GAP 0.5      // Predicted switch points never get closer than this
+
+// Bits of ThermalModel::seeded
+enum ThermalParameter : uint8_t {
+    ThermalOvershoot = 1,
+    ThermalUndershoot = 2
+};
+
+// Thermal behaviour of one box, learned from its own heater cycles
+struct ThermalModel
+{
+    float overshoot = 0;  // C the temperature keeps rising after the heater is switched off
+    float undershoot = 0; // C the temperature keeps falling after the heater is switched on
+    uint8_t cycles = 0;   // Heater cycles learned from, saturates
+    uint8_t seeded = 0;   // ThermalParameter bits of the values measured at least once
+    uint8_t magic = THERMAL_MODEL_MAGIC;
+};
+
+inline int thermalEepromAddress(uint8_t zone)
+{
+    return THERMAL_EEPROM_BASE + zone * sizeof(ThermalModel);
+}
+
+// Feeds a sample and the heater state it was taken under, call before toggleHeater
+void thermalLearn(uint8_t zone, float temperature, bool heaterRunning);
+
+// Loads the models from EEPROM and starts observing the heater phases afresh
+void thermalLoad();
+
+// Writes changed models to EEPROM, rate limited to save the EEPROM
+void maybeSaveThermal(unsigned long currentTime);
+
+#endif // THERMAL_H
\ No newline at end of file
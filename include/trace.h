@@ -0,0 +1,70 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+
+// Record and replay of everything that drives the controller, so field behaviour can be reproduced.
+// With -DDRYBOX_TRACE every input (sensor readings, button edges) and every output (heater switches,
+// menu changes) is printed as a "$TRC,<hex>" line from boot on. The replay environment (-DDRYBOX_REPLAY)
+// is a host build against the stand-ins in lib/native: it reads those lines from a file, runs them through
+// loopPass() on the virtual clock and reports every output that differs from the recording.
+//
+// Record: kind << 4 | index, milliseconds since the previous record (uint16, little endian), payload
+enum TraceKind : uint8_t {
+    TraceStart = 0,        // Settings of a zone the trace starts from, TraceStartPayload
+    TraceSample = 1,       // Input: uncalibrated reading of a zone, temperature and humidity in 0.01 (int16, int16)
+    TraceSampleFailed = 2, // Input: zone sensor did not answer
+    TraceButton = 3,       // Input: button changed, bit 0 pressed, bits 1-7 zone shown on the screen
+    TraceHeater = 4,       // Output: heater of a zone switched, 1 on
+    TraceMenu = 5,         // Output: menu changed, new DeviceState
+    TraceGap = 6           // Time passing without an event, for pauses that do not fit 16 bits
+};
+
+#define TRACE_PREFIX "$TRC,"
+#define TRACE_RECORD_MAX 32
+
+struct __attribute__((packed)) TraceStartPayload
+{
+    float targetTemp;
+    int16_t temperatureGain; // Calibration
+    int16_t temperatureOffset;
+    int16_t humidityGain;
+    int16_t humidityOffset;
+    float overshoot;
+    float undershoot;
+    uint16_t targetHumidity;
+    uint8_t flags; // Bit 0 heater on, bit 1 unit is Fahrenheit
+    uint8_t cycles;
+    uint8_t seeded; // ThermalParameter bits, with overshoot, undershoot and cycles the whole learned ThermalModel
+};
+
+#if defined(DRYBOX_TRACE) || defined(DRYBOX_REPLAY)
+void traceStart(unsigned long time);
+void traceSample(uint8_t zone, bool sampled, unsigned long time);
+void traceButtons(bool onOff, bool up, bool down, unsigned long time);
+void traceHeater(uint8_t zone, bool on, unsigned long time);
+void traceMenu(uint8_t state, unsigned long time);
+#else
+inline void traceStart(unsigned long) {}
+inline void traceSample(uint8_t, bool, unsigned long) {}
+inline void traceButtons(bool, bool, bool, unsigned long) {}
+inline void traceHeater(uint8_t, bool, unsigned long) {}
+inline void traceMenu(uint8_t, unsigned long) {}
+#endif
+
+#ifdef DRYBOX_REPLAY
+#include <stdio.h>
+
+struct ReplayResult
+{
+    unsigned long records;
+    unsigned long passes;
+    unsigned long divergences; // Each one is also printed as $DIV,<time>,<what>,<kind>,<zone>,<value>
+};
+
+// Host only, in place of the first sampleAllZones() of setup() and of loop(): replays the trace lines of a file
+// up to its end or "$END". afterPass is called after every pass with its time, so the state can be checked.
+ReplayResult replayRun(FILE *file, void (*afterPass)(unsigned long time) = nullptr);
+#endif
+
+#endif // TRACE_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef ZONE_H
+#define ZONE_H
+
+#include <stdint.h>
+
+#include "calibration.h"
+#include "thermal.h"
+
+// Number of boxes driven by this controller, each with its own sensor and heater output
+#ifndef ZONE_COUNT
+#define ZONE_COUNT 1
+#endif
+
+#if ZONE_COUNT > 8
+#error "The TCA9548A multiplexer has 8 channels, ZONE_COUNT can be at most 8"
+#endif
+
+#if ZONE_COUNT > 1 && !defined(ZONE_HEATER_PINS)
+#error "ZONE_HEATER_PINS has to list one heater pin per zone, e.g. -DZONE_HEATER_PINS=\"{10,9}\""
+#endif
+
+#define HEATER_HYSTERESIS 1.5 // Temperature is kept within target +/- this many degrees Celsius
+
+// Every zone is read at its own interval, short while readings move fast or near a switch point, long while stable
+#ifndef SENSOR_MIN_INTERVAL
+#define SENSOR_MIN_INTERVAL 2000UL // ms, the DHT20 heats itself up when measuring more often
+#endif
+#ifndef SENSOR_MAX_INTERVAL
+#define SENSOR_MAX_INTERVAL 20000UL // ms, leaves room for a retry within the interlock's stale sensor timeout
+#endif
+#define SENSOR_MIN_STEP 0.1 // Change (C or %) a reading may make unseen right at a switch point
+#define SENSOR_MAX_STEP 1.0 // Change a reading may make unseen far from any switch point
+
+#if SENSOR_MIN_INTERVAL < 2000
+#error "The DHT20 must not be read more often than every 2 s, SENSOR_MIN_INTERVAL is too short"
+#endif
+
+// Source of temperature (Celsius) and humidity (percent) readings of a zone.
+// Kept abstract and this header free of Arduino includes, so the zone logic runs on the host with mock sensors.
+class ZoneSensor
+{
+public:
+    virtual bool begin() = 0;
+    virtual bool read(float &temperature, float &humidity) = 0;
+};
+
+struct Zone
+{
+    ZoneSensor *sensor = nullptr;
+    uint8_t heaterPin = 0;
+
+    bool heaterOn = false;      // Heater enabled by the user
+    bool heaterRunning = false; // Heater output currently driven
+
+    // Temperature internally is always represented as Celsius, but can be displayed in Fahrenheit if defined.
+    // Readings are calibrated as they are taken, everything else works with the calibrated values.
+    float temperature = 255.0; // Default value for temperature, will be updated by the sensor
+    float humidity = 99.0;     // Default value for humidity, will be updated by the sensor
+    int16_t rawTemperature = 0; // Uncalibrated reading in 0.01 C, kept for calibrating
+    int16_t rawHumidity = 0;    // Uncalibrated reading in 0.01 %
+    float targetTemp = 45;
+    unsigned short targetHumidity = 30;
+    Calibration temperatureCalibration;
+    Calibration humidityCalibration;
+    ThermalModel thermal;
+
+    unsigned long lastSensorUpdate = 0;                 // Last successful reading
+    unsigned long lastSampleTime = 0;                   // Last read attempt
+    unsigned short sampleInterval = SENSOR_MIN_INTERVAL; // Current adaptive interval in ms
+};
+
+// EEPROM address of a zone's settings block, zone 0 keeps the layout of the single box firmware
+inline int zoneEepromAddress(uint8_t zone)
+{
+    return zone == 0 ? 0 : 32 + (zone - 1) * 16;
+}
+
+// Reads the zone's sensor, returns false if the sensor did not answer
+bool zoneSample(Zone &zone);
+
+// Works out the calibrated readings from the raw ones, again after the calibration changed
+void zoneApplyCalibration(Zone &zone);
+
+// Temperatures the heater switches on below and off above, including the learned thermal lag
+void zoneSwitchPoints(const Zone &zone, float &switchOnAt, float &switchOffAt);
+
+// Heater state the zone asks for given its latest reading and targets
+bool zoneHeaterDemand(const Zone &zone);
+
+// Zone to read next, or count if none is due. Reads are spaced SENSOR_MIN_INTERVAL / count apart so the bus is never
+// contended, of the zones whose interval has passed the most overdue one goes first.
+uint8_t zoneNextDue(const Zone zones[], uint8_t count, unsigned long lastRead, unsigned long currentTime);
+
+// Picks the next sample interval from how fast the readings moved since the previous ones and how close they are to a switch point
+void zoneAdaptInterval(Zone &zone, float lastTemperature, float lastHumidity, unsigned long elapsed);
+
+#endif // ZONE_H
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef NATIVE_ADAFRUIT_GFX_H
+#define NATIVE_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+struct GFXfont
+{
+};
+
+// Keeps the text of the frame being drawn instead of pixels. Every setCursor starts a new line of
+// the text, so a test can check what a screen shows without knowing where exactly it is drawn.
+class Adafruit_GFX : public Print
+{
+protected:
+    int16_t width;
+    int16_t height;
+    std::string text;
+
+public:
+    Adafruit_GFX(int16_t width, int16_t height) : width(width), height(height) {}
+
+    void setFont(const GFXfont *font);
+    void setTextColor(uint16_t color);
+    void setTextSize(uint8_t size);
+    void setCursor(int16_t x, int16_t y);
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void fillCircle(int16_t x, int16_t y, int16_t r, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color);
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+};
+
+#endif // NATIVE_ADAFRUIT_GFX_H
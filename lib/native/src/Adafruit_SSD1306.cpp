@@ -0,0 +1,97 @@
+#include "Adafruit_SSD1306.h"
+
+void Adafruit_GFX::setFont(const GFXfont *)
+{
+}
+
+void Adafruit_GFX::setTextColor(uint16_t)
+{
+}
+
+void Adafruit_GFX::setTextSize(uint8_t)
+{
+}
+
+void Adafruit_GFX::setCursor(int16_t, int16_t)
+{
+    if (!text.empty() && text.back() != '\n')
+        text += '\n';
+}
+
+void Adafruit_GFX::drawPixel(int16_t, int16_t, uint16_t)
+{
+}
+
+void Adafruit_GFX::drawLine(int16_t, int16_t, int16_t, int16_t, uint16_t)
+{
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t, int16_t, int16_t, uint16_t)
+{
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t, int16_t, int16_t, uint16_t)
+{
+}
+
+void Adafruit_GFX::drawRect(int16_t, int16_t, int16_t, int16_t, uint16_t)
+{
+}
+
+void Adafruit_GFX::fillRect(int16_t, int16_t, int16_t, int16_t, uint16_t)
+{
+}
+
+void Adafruit_GFX::fillCircle(int16_t, int16_t, int16_t, uint16_t)
+{
+}
+
+void Adafruit_GFX::drawBitmap(int16_t, int16_t, const uint8_t *, int16_t, int16_t, uint16_t)
+{
+}
+
+size_t Adafruit_GFX::write(uint8_t c)
+{
+    if (c == '\r')
+        return 1;
+    if (c != '\n' || (!text.empty() && text.back() != '\n'))
+        text += (char)c;
+    return 1;
+}
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t width, uint8_t height, TwoWire *, int8_t) : Adafruit_GFX(width, height)
+{
+}
+
+bool Adafruit_SSD1306::begin(uint8_t, uint8_t)
+{
+    return true;
+}
+
+void Adafruit_SSD1306::clearDisplay()
+{
+    text.clear();
+}
+
+void Adafruit_SSD1306::display()
+{
+    frame = text;
+    frames++;
+}
+
+void Adafruit_SSD1306::dim(bool dim)
+{
+    dimmed = dim;
+}
+
+void Adafruit_SSD1306::invertDisplay(bool)
+{
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t command)
+{
+    if (command == SSD1306_DISPLAYOFF)
+        on = false;
+    else if (command == SSD1306_DISPLAYON)
+        on = true;
+}
@@ -0,0 +1,31 @@
+#ifndef NATIVE_ADAFRUIT_SSD1306_H
+#define NATIVE_ADAFRUIT_SSD1306_H
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+
+class Adafruit_SSD1306 : public Adafruit_GFX
+{
+public:
+    std::string frame;         // Text of the last frame pushed with display()
+    unsigned long frames = 0;  // Frames pushed so far
+    bool on = true;            // Panel switched on
+    bool dimmed = false;
+
+    Adafruit_SSD1306(uint8_t width, uint8_t height, TwoWire *wire, int8_t resetPin);
+
+    bool begin(uint8_t vccState, uint8_t address);
+    void clearDisplay();
+    void display();
+    void dim(bool dim);
+    void invertDisplay(bool invert);
+    void ssd1306_command(uint8_t command);
+};
+
+#endif // NATIVE_ADAFRUIT_SSD1306_H
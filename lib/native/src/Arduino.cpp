@@ -0,0 +1,298 @@
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "native.h"
+
+unsigned long nativeTime = 0;
+uint8_t nativePinLevel[NATIVE_PIN_COUNT];
+uint8_t nativePinMode[NATIVE_PIN_COUNT];
+
+HardwareSerial Serial;
+
+unsigned long millis()
+{
+    return nativeTime;
+}
+
+unsigned long micros()
+{
+    return nativeTime * 1000;
+}
+
+void delay(unsigned long ms)
+{
+    nativeTime += ms;
+}
+
+void delayMicroseconds(unsigned int)
+{
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin >= NATIVE_PIN_COUNT)
+        return;
+    nativePinMode[pin] = mode;
+    if (mode == INPUT_PULLUP)
+        nativePinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin >= NATIVE_PIN_COUNT)
+        return;
+    nativePinLevel[pin] = value ? HIGH : LOW;
+    if (pin == 9)
+        TCCR1A &= ~_BV(COM1A1); // Like the core, a digital write disconnects the pin from its timer
+    else if (pin == 10)
+        TCCR1A &= ~_BV(COM1B1);
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < NATIVE_PIN_COUNT ? nativePinLevel[pin] : LOW;
+}
+
+void nativeSetPin(uint8_t pin, uint8_t level)
+{
+    if (pin < NATIVE_PIN_COUNT)
+        nativePinLevel[pin] = level;
+}
+
+uint8_t digitalPinToTimer(uint8_t pin)
+{
+    // Only the Timer1 outputs matter to the firmware
+    if (pin == 9)
+        return TIMER1A;
+    if (pin == 10)
+        return TIMER1B;
+    return NOT_A_TIMER;
+}
+
+volatile uint8_t *digitalPinToPCMSK(uint8_t pin)
+{
+    if (pin <= 7)
+        return &PCMSK2;
+    if (pin <= 13)
+        return &PCMSK0;
+    return &PCMSK1;
+}
+
+uint8_t digitalPinToPCMSKbit(uint8_t pin)
+{
+    if (pin <= 7)
+        return pin;
+    if (pin <= 13)
+        return pin - 8;
+    return pin - 14;
+}
+
+volatile uint8_t *digitalPinToPCICR(uint8_t)
+{
+    return &PCICR;
+}
+
+uint8_t digitalPinToPCICRbit(uint8_t pin)
+{
+    if (pin <= 7)
+        return 2;
+    if (pin <= 13)
+        return 0;
+    return 1;
+}
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer)
+{
+    sprintf(buffer, "%*.*f", width, precision, value);
+    return buffer;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+        n += write(*buffer++);
+    return n;
+}
+
+size_t Print::write(const char *str)
+{
+    return str ? write((const uint8_t *)str, strlen(str)) : 0;
+}
+
+size_t Print::printNumber(unsigned long value, uint8_t base)
+{
+    char buffer[8 * sizeof(long) + 1];
+    char *p = &buffer[sizeof(buffer) - 1];
+    *p = '\0';
+
+    if (base < 2)
+        base = 10;
+    do
+    {
+        unsigned long digit = value % base;
+        value /= base;
+        *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    } while (value);
+
+    return write(p);
+}
+
+// Same output as the AVR core, including its "nan", "inf" and "ovf"
+size_t Print::printFloat(double value, uint8_t digits)
+{
+    if (isnan(value))
+        return print("nan");
+    if (isinf(value))
+        return print("inf");
+    if (value > 4294967040.0 || value < -4294967040.0)
+        return print("ovf");
+
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return print(buffer);
+}
+
+size_t Print::print(const __FlashStringHelper *str)
+{
+    return write(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(const char *str)
+{
+    return write(str);
+}
+
+size_t Print::print(char c)
+{
+    return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char value, int base)
+{
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(int value, int base)
+{
+    return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base)
+{
+    if (base == 0)
+        return write((uint8_t)value);
+    if (base == 10 && value < 0)
+        return print('-') + printNumber(-(unsigned long)value, 10);
+    return printNumber(value, base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    if (base == 0)
+        return write((uint8_t)value);
+    return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits)
+{
+    return printFloat(value, digits);
+}
+
+size_t Print::println()
+{
+    return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *str)
+{
+    return print(str) + println();
+}
+
+size_t Print::println(const char *str)
+{
+    return print(str) + println();
+}
+
+size_t Print::println(char c)
+{
+    return print(c) + println();
+}
+
+size_t Print::println(unsigned char value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(int value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned int value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(long value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long value, int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(double value, int digits)
+{
+    return print(value, digits) + println();
+}
+
+void HardwareSerial::begin(unsigned long)
+{
+}
+
+void HardwareSerial::end()
+{
+}
+
+void HardwareSerial::flush()
+{
+}
+
+int HardwareSerial::available()
+{
+    return 0;
+}
+
+int HardwareSerial::read()
+{
+    return -1;
+}
+
+int HardwareSerial::peek()
+{
+    return -1;
+}
+
+int HardwareSerial::availableForWrite()
+{
+    return 63;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    output += (char)c;
+    return 1;
+}
+
+HardwareSerial::operator bool()
+{
+    return true;
+}
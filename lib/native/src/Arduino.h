@@ -0,0 +1,140 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Host stand-in for the parts of the Arduino core the firmware uses.
+// Time is a virtual clock that only moves when a test or a delay moves it, see native.h.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define NOT_A_TIMER 0
+#define TIMER1A 3
+#define TIMER1B 4
+
+#define NATIVE_PIN_COUNT 20
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+template <class A, class B>
+inline auto min(A a, B b) -> decltype(a + b)
+{
+    return a < b ? a : b;
+}
+
+template <class A, class B>
+inline auto max(A a, B b) -> decltype(a + b)
+{
+    return a > b ? a : b;
+}
+
+template <class A, class B, class C>
+inline A constrain(A value, B low, C high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+uint8_t digitalPinToTimer(uint8_t pin);
+volatile uint8_t *digitalPinToPCMSK(uint8_t pin);
+uint8_t digitalPinToPCMSKbit(uint8_t pin);
+volatile uint8_t *digitalPinToPCICR(uint8_t pin);
+uint8_t digitalPinToPCICRbit(uint8_t pin);
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer);
+
+class Print
+{
+private:
+    size_t printNumber(unsigned long value, uint8_t base);
+    size_t printFloat(double value, uint8_t digits);
+
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str);
+
+    size_t print(const __FlashStringHelper *str);
+    size_t print(const char *str);
+    size_t print(char c);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println();
+    size_t println(const __FlashStringHelper *str);
+    size_t println(const char *str);
+    size_t println(char c);
+    size_t println(unsigned char value, int base = DEC);
+    size_t println(int value, int base = DEC);
+    size_t println(unsigned int value, int base = DEC);
+    size_t println(long value, int base = DEC);
+    size_t println(unsigned long value, int base = DEC);
+    size_t println(double value, int digits = 2);
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// Everything printed is collected in output, nothing can be received
+class HardwareSerial : public Stream
+{
+public:
+    std::string output;
+
+    void begin(unsigned long baud);
+    void end();
+    void flush();
+    int available() override;
+    int read() override;
+    int peek() override;
+    int availableForWrite();
+    size_t write(uint8_t c) override;
+    using Print::write;
+    operator bool();
+};
+
+extern HardwareSerial Serial;
+
+#endif // ARDUINO_H
@@ -0,0 +1,46 @@
+#include "DFRobot_DHT20.h"
+
+DFRobot_DHT20::DFRobot_DHT20(TwoWire *wire, uint8_t address) : wire(wire), address(address)
+{
+}
+
+int DFRobot_DHT20::begin()
+{
+    delay(100);
+    wire->beginTransmission(address);
+    wire->write(0x71);
+    if (wire->endTransmission() != 0 || wire->requestFrom(address, (uint8_t)1) != 1)
+        return 1;
+    return (wire->read() & 0x18) == 0x18 ? 0 : 1;
+}
+
+bool DFRobot_DHT20::measure(uint8_t *data)
+{
+    wire->beginTransmission(address);
+    wire->write(0xAC);
+    wire->write(0x33);
+    wire->write(0x00);
+    wire->endTransmission();
+    delay(80);
+    if (wire->requestFrom(address, (uint8_t)6) != 6)
+        return false;
+    for (uint8_t i = 0; i < 6; i++)
+        data[i] = wire->read();
+    return true;
+}
+
+float DFRobot_DHT20::getTemperature()
+{
+    uint8_t data[6] = {0};
+    measure(data);
+    uint32_t raw = (uint32_t)(data[3] & 0x0F) << 16 | (uint32_t)data[4] << 8 | data[5];
+    return raw * 200.0 / (1UL << 20) - 50;
+}
+
+float DFRobot_DHT20::getHumidity()
+{
+    uint8_t data[6] = {0};
+    measure(data);
+    uint32_t raw = (uint32_t)data[1] << 12 | (uint32_t)data[2] << 4 | data[3] >> 4;
+    return raw / (float)(1UL << 20);
+}
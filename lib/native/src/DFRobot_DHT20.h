@@ -0,0 +1,24 @@
+#ifndef NATIVE_DFROBOT_DHT20_H
+#define NATIVE_DFROBOT_DHT20_H
+
+#include <Wire.h>
+
+// Same interface and bus traffic as the DFRobot library, talks to a NativeDht20 on the stand-in bus
+class DFRobot_DHT20
+{
+private:
+    TwoWire *wire;
+    uint8_t address;
+
+    bool measure(uint8_t *data);
+
+public:
+    DFRobot_DHT20(TwoWire *wire = &Wire, uint8_t address = 0x38);
+
+    // 0 on success
+    int begin();
+    float getTemperature();
+    float getHumidity(); // 0 to 1
+};
+
+#endif // NATIVE_DFROBOT_DHT20_H
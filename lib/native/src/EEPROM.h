@@ -0,0 +1,61 @@
+#ifndef EEPROM_H
+#define EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define NATIVE_EEPROM_SIZE 1024
+
+// EEPROM of the ATmega328P in RAM, erased (0xFF) at start like a new chip
+struct EEPROMClass
+{
+    uint8_t data[NATIVE_EEPROM_SIZE];
+
+    EEPROMClass()
+    {
+        erase();
+    }
+
+    void erase()
+    {
+        memset(data, 0xFF, sizeof(data));
+    }
+
+    uint8_t read(int address)
+    {
+        return data[address];
+    }
+
+    void write(int address, uint8_t value)
+    {
+        data[address] = value;
+    }
+
+    void update(int address, uint8_t value)
+    {
+        data[address] = value;
+    }
+
+    uint16_t length()
+    {
+        return NATIVE_EEPROM_SIZE;
+    }
+
+    template <typename T>
+    T &get(int address, T &value)
+    {
+        memcpy(&value, data + address, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    const T &put(int address, const T &value)
+    {
+        memcpy(data + address, &value, sizeof(T));
+        return value;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // EEPROM_H
@@ -0,0 +1,8 @@
+#ifndef NATIVE_FREEMONO9PT7B_H
+#define NATIVE_FREEMONO9PT7B_H
+
+#include <Adafruit_GFX.h>
+
+const GFXfont FreeMono9pt7b = {};
+
+#endif // NATIVE_FREEMONO9PT7B_H
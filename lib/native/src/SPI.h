@@ -0,0 +1,6 @@
+#ifndef NATIVE_SPI_H
+#define NATIVE_SPI_H
+
+// The display is on I2C, SPI is only included
+
+#endif // NATIVE_SPI_H
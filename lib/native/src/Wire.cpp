@@ -0,0 +1,76 @@
+#include "Wire.h"
+#include "native.h"
+
+TwoWire Wire;
+
+static NativeI2cDevice *devices[128];
+
+void nativeI2cAttach(uint8_t address, NativeI2cDevice *device)
+{
+    devices[address & 0x7F] = device;
+}
+
+void TwoWire::begin()
+{
+}
+
+void TwoWire::end()
+{
+}
+
+void TwoWire::setClock(uint32_t)
+{
+}
+
+void TwoWire::setWireTimeout(uint32_t, bool)
+{
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    txAddress = address;
+    txLength = 0;
+}
+
+// Same codes as the AVR core: 0 success, 2 address not acknowledged, 3 data not acknowledged
+uint8_t TwoWire::endTransmission(bool)
+{
+    NativeI2cDevice *device = devices[txAddress & 0x7F];
+    if (!device)
+        return 2;
+    return device->receive(txBuffer, txLength) ? 0 : 3;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool)
+{
+    NativeI2cDevice *device = devices[address & 0x7F];
+    if (quantity > WIRE_BUFFER_LENGTH)
+        quantity = WIRE_BUFFER_LENGTH;
+
+    rxIndex = 0;
+    rxLength = device ? device->send(rxBuffer, quantity) : 0;
+    return rxLength;
+}
+
+size_t TwoWire::write(uint8_t c)
+{
+    if (txLength >= WIRE_BUFFER_LENGTH)
+        return 0;
+    txBuffer[txLength++] = c;
+    return 1;
+}
+
+int TwoWire::available()
+{
+    return rxLength - rxIndex;
+}
+
+int TwoWire::read()
+{
+    return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
+
+int TwoWire::peek()
+{
+    return rxIndex < rxLength ? rxBuffer[rxIndex] : -1;
+}
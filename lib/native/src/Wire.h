@@ -0,0 +1,45 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <Arduino.h>
+
+#define WIRE_BUFFER_LENGTH 32
+
+class NativeI2cDevice;
+
+// I2C master talking to the NativeI2cDevice objects attached with nativeI2cAttach(), addresses
+// without a device do not acknowledge
+class TwoWire : public Stream
+{
+private:
+    uint8_t txAddress = 0;
+    uint8_t txBuffer[WIRE_BUFFER_LENGTH];
+    uint8_t txLength = 0;
+    uint8_t rxBuffer[WIRE_BUFFER_LENGTH];
+    uint8_t rxLength = 0;
+    uint8_t rxIndex = 0;
+
+public:
+    void begin();
+    void end();
+    void setClock(uint32_t clock);
+    void setWireTimeout(uint32_t timeout = 25000, bool reset = false);
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+    size_t write(int c)
+    {
+        return write((uint8_t)c);
+    }
+    int available() override;
+    int read() override;
+    int peek() override;
+};
+
+extern TwoWire Wire;
+
+#endif // WIRE_H
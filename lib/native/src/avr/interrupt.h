@@ -0,0 +1,17 @@
+#ifndef NATIVE_AVR_INTERRUPT_H
+#define NATIVE_AVR_INTERRUPT_H
+
+// Interrupt handlers become plain functions a test calls to stand in for the interrupt,
+// e.g. TIMER2_COMPA_vect() for one interlock tick
+#define ISR(vector, ...) extern "C" void vector(void)
+#define ISR_ALIASOF(vector)
+
+inline void cli()
+{
+}
+
+inline void sei()
+{
+}
+
+#endif // NATIVE_AVR_INTERRUPT_H
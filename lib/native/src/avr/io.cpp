@@ -0,0 +1,24 @@
+#include <avr/io.h>
+
+volatile uint8_t MCUSR;
+volatile uint8_t ADCSRA;
+volatile uint8_t ACSR;
+volatile uint8_t PRR;
+volatile uint8_t PCICR;
+volatile uint8_t PCMSK0;
+volatile uint8_t PCMSK1;
+volatile uint8_t PCMSK2;
+volatile uint8_t TCCR1A;
+volatile uint8_t TCCR1B;
+volatile uint8_t TIMSK1;
+volatile uint8_t TIFR1;
+volatile uint16_t TCNT1;
+volatile uint16_t ICR1;
+volatile uint16_t OCR1A;
+volatile uint16_t OCR1B;
+volatile uint8_t TCCR2A;
+volatile uint8_t TCCR2B;
+volatile uint8_t TIMSK2;
+volatile uint8_t OCR2A;
+volatile uint8_t TCNT2;
+volatile uint16_t SP;
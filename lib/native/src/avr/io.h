@@ -0,0 +1,69 @@
+#ifndef NATIVE_AVR_IO_H
+#define NATIVE_AVR_IO_H
+
+// ATmega328P registers the firmware touches, as plain variables so timer and power setup run on the host
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define _BV(bit) (1 << (bit))
+
+extern volatile uint8_t MCUSR;
+extern volatile uint8_t ADCSRA;
+extern volatile uint8_t ACSR;
+extern volatile uint8_t PRR;
+extern volatile uint8_t PCICR;
+extern volatile uint8_t PCMSK0;
+extern volatile uint8_t PCMSK1;
+extern volatile uint8_t PCMSK2;
+extern volatile uint8_t TCCR1A;
+extern volatile uint8_t TCCR1B;
+extern volatile uint8_t TIMSK1;
+extern volatile uint8_t TIFR1;
+extern volatile uint16_t TCNT1;
+extern volatile uint16_t ICR1;
+extern volatile uint16_t OCR1A;
+extern volatile uint16_t OCR1B;
+extern volatile uint8_t TCCR2A;
+extern volatile uint8_t TCCR2B;
+extern volatile uint8_t TIMSK2;
+extern volatile uint8_t OCR2A;
+extern volatile uint8_t TCNT2;
+extern volatile uint16_t SP;
+
+// MCUSR
+#define PORF 0
+#define EXTRF 1
+#define BORF 2
+#define WDRF 3
+
+// ADCSRA, ACSR
+#define ADEN 7
+#define ACD 7
+
+// Timer1
+#define WGM10 0
+#define WGM11 1
+#define COM1B0 4
+#define COM1B1 5
+#define COM1A0 6
+#define COM1A1 7
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+#define WGM13 4
+#define TOIE1 0
+#define TOV1 0
+
+// Timer2
+#define WGM21 1
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define OCIE2A 1
+
+#endif // NATIVE_AVR_IO_H
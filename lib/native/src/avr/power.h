@@ -0,0 +1,13 @@
+#ifndef NATIVE_AVR_POWER_H
+#define NATIVE_AVR_POWER_H
+
+inline void power_adc_disable() {}
+inline void power_spi_disable() {}
+inline void power_twi_disable() {}
+inline void power_usart0_disable() {}
+inline void power_timer1_enable() {}
+inline void power_timer1_disable() {}
+inline void power_timer2_enable() {}
+inline void power_timer2_disable() {}
+
+#endif // NATIVE_AVR_POWER_H
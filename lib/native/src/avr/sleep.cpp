@@ -0,0 +1,9 @@
+#include <Arduino.h>
+#include <avr/sleep.h>
+
+#include "native.h"
+
+void sleep_cpu()
+{
+    nativeTime++;
+}
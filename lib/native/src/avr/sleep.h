@@ -0,0 +1,13 @@
+#ifndef NATIVE_AVR_SLEEP_H
+#define NATIVE_AVR_SLEEP_H
+
+#define SLEEP_MODE_IDLE 0
+
+inline void set_sleep_mode(int) {}
+inline void sleep_enable() {}
+inline void sleep_disable() {}
+
+// Idle sleep lasts until the next Timer0 overflow, about a millisecond
+void sleep_cpu();
+
+#endif // NATIVE_AVR_SLEEP_H
@@ -0,0 +1,12 @@
+#ifndef NATIVE_AVR_WDT_H
+#define NATIVE_AVR_WDT_H
+
+#define WDTO_500MS 5
+#define WDTO_1S 6
+#define WDTO_2S 7
+
+inline void wdt_enable(int) {}
+inline void wdt_disable() {}
+inline void wdt_reset() {}
+
+#endif // NATIVE_AVR_WDT_H
@@ -0,0 +1,52 @@
+#include "native.h"
+
+uint8_t nativeDht20Crc(const uint8_t *data, uint8_t length)
+{
+    uint8_t crc = 0xFF;
+    while (length--)
+    {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+    }
+    return crc;
+}
+
+bool NativeDht20::receive(const uint8_t *data, uint8_t length)
+{
+    if (length > 0 && data[0] == 0xAC)
+        triggers++;
+    return true;
+}
+
+uint8_t NativeDht20::send(uint8_t *data, uint8_t length)
+{
+    uint32_t rawHumidity = lround(constrain(humidity, 0.0f, 100.0f) / 100.0 * (1UL << 20));
+    uint32_t rawTemperature = lround(constrain(temperature + 50, 0.0f, 200.0f) / 200.0 * (1UL << 20));
+    rawHumidity = min(rawHumidity, 0xFFFFFUL);
+    rawTemperature = min(rawTemperature, 0xFFFFFUL);
+
+    uint8_t frame[7];
+    frame[0] = (busy ? 0x80 : 0) | 0x10 | (calibrated ? 0x08 : 0);
+    frame[1] = rawHumidity >> 12;
+    frame[2] = rawHumidity >> 4;
+    frame[3] = (rawHumidity & 0x0F) << 4 | rawTemperature >> 16;
+    frame[4] = rawTemperature >> 8;
+    frame[5] = rawTemperature;
+    frame[6] = nativeDht20Crc(frame, 6) ^ (corrupt ? 0xFF : 0);
+
+    if (length > sizeof(frame))
+        length = sizeof(frame);
+    memcpy(data, frame, length);
+    return length;
+}
+
+void NativePlant::run(unsigned long ms, float duty)
+{
+    for (unsigned long step = 0; step < ms; step += 1000)
+    {
+        float flow = elementCoupling * (element - air);
+        element += (power * duty - flow) / elementCapacity;
+        air += (flow - airLoss * (air - ambient)) / airCapacity;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef NATIVE_H
+#define NATIVE_H
+
+// Handles for tests on the host stand-ins: the virtual clock, pin levels and devices on the I2C bus
+
+#include <Arduino.h>
+
+extern unsigned long nativeTime; // What millis() returns, only moves when a test, delay() or idle sleep moves it
+extern uint8_t nativePinLevel[NATIVE_PIN_COUNT];
+
+// Drives an input pin, e.g. LOW for a pressed button
+void nativeSetPin(uint8_t pin, uint8_t level);
+
+class NativeI2cDevice
+{
+public:
+    virtual ~NativeI2cDevice() {}
+
+    // Master wrote these bytes, false does not acknowledge them
+    virtual bool receive(const uint8_t *data, uint8_t length) = 0;
+
+    // Master reads up to length bytes, returns how many the device supplied
+    virtual uint8_t send(uint8_t *data, uint8_t length) = 0;
+};
+
+// Puts a device on the bus at a 7 bit address, nullptr takes it off again
+void nativeI2cAttach(uint8_t address, NativeI2cDevice *device);
+
+#define NATIVE_DHT20_ADDRESS 0x38
+
+// DHT20 answering measurements with the status byte and CRC of the real sensor
+class NativeDht20 : public NativeI2cDevice
+{
+public:
+    float temperature = 25.0; // C
+    float humidity = 50.0;    // %
+    bool busy = false;        // Status reports a measurement still running
+    bool calibrated = true;   // Status reports the calibration as loaded
+    bool corrupt = false;     // CRC does not match the data
+    unsigned long triggers = 0;
+
+    bool receive(const uint8_t *data, uint8_t length) override;
+    uint8_t send(uint8_t *data, uint8_t length) override;
+};
+
+// Heated box as two lumped nodes, the heater element with its own heat capacity and the air around it.
+// The element keeps warming the air after the heater is switched off, which is the lag the firmware learns.
+class NativePlant
+{
+public:
+    float ambient = 22.0;          // C
+    float power = 60.0;            // W at full duty
+    float elementCapacity = 600.0; // J/K, larger means more lag
+    float elementCoupling = 3.0;   // W/K from the element to the air
+    float airCapacity = 2000.0;    // J/K
+    float airLoss = 0.8;           // W/K from the air to the ambient
+    float element = 22.0;          // C
+    float air = 22.0;              // C, what the sensor sees
+
+    // Advances the plant by ms in 1 s steps with the heater at a duty of 0 to 1
+    void run(unsigned long ms, float duty);
+};
+
+// CRC-8 of the DHT20, polynomial 0x31, initial value 0xFF
+uint8_t nativeDht20Crc(const uint8_t *data, uint8_t length);
+
+#endif // NATIVE_H
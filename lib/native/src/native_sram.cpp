@@ -0,0 +1,16 @@
+#include <sram.h>
+
+// src/sram.cpp scans the AVR stack through linker symbols that do not exist on the host, so the
+// native environment leaves it out and reports a healthy memory state instead
+
+MemoryStats memoryStats = {1024, 1024, 0, 0};
+bool memoryAlarm = false;
+
+void memoryCheck()
+{
+}
+
+bool maybeCheckMemory(unsigned long)
+{
+    return false;
+}
@@ -0,0 +1,8 @@
+#ifndef NATIVE_UTIL_ATOMIC_H
+#define NATIVE_UTIL_ATOMIC_H
+
+// Interrupts only run when a test calls them, so every block is atomic already
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_BLOCK(type) for (bool atomicOnce = true; atomicOnce; atomicOnce = false)
+
+#endif // NATIVE_UTIL_ATOMIC_H
@@ -0,0 +1,102 @@
+#ifdef DRYBOX_BENCHMARK
+
+#include <avr/interrupt.h>
+#include <avr/power.h>
+
+#include "benchmark.h"
+#include "drybox.h"
+#include "menu.h"
+#include "screen.h"
+
+// Timer1 runs at the CPU clock while a benchmark is measured, overflows extend it to 32 bits
+static volatile uint16_t timer1Overflows = 0;
+static uint32_t counterOverhead = 0;
+
+ISR(TIMER1_OVF_vect)
+{
+    timer1Overflows++;
+}
+
+static void startCycleCounter()
+{
+    TCCR1B = 0;
+    TCCR1A = 0;
+    TCNT1 = 0;
+    timer1Overflows = 0;
+    TIFR1 = _BV(TOV1);
+    TIMSK1 = _BV(TOIE1);
+    TCCR1B = _BV(CS10); // No prescaler, one count per cycle
+}
+
+static uint32_t stopCycleCounter()
+{
+    TCCR1B = 0;
+    cli();
+    uint32_t cycles = ((uint32_t)timer1Overflows << 16) | TCNT1;
+    if (TIFR1 & _BV(TOV1))
+    {
+        cycles += 0x10000UL; // Overflow happened right before the stop and was not serviced yet
+        TIFR1 = _BV(TOV1);
+    }
+    TIMSK1 = 0;
+    sei();
+    return cycles;
+}
+
+static void report(const __FlashStringHelper *name, uint32_t minCycles, uint32_t maxCycles)
+{
+    Serial.print(F("{\"benchmark\":\""));
+    Serial.print(name);
+    Serial.print(F("\",\"runs\":"));
+    Serial.print(BENCHMARK_RUNS);
+    Serial.print(F(",\"min_cycles\":"));
+    Serial.print(minCycles);
+    Serial.print(F(",\"max_cycles\":"));
+    Serial.print(maxCycles);
+    Serial.println('}');
+    Serial.flush(); // Keep the UART interrupts out of the next measurement
+}
+
+// Measures statement BENCHMARK_RUNS times and reports the fastest and slowest run, prepare runs unmeasured before each
+#define BENCHMARK_PREPARED(name, prepare, statement)                 \
+    {                                                                \
+        uint32_t minCycles = 0xFFFFFFFFUL;                           \
+        uint32_t maxCycles = 0;                                      \
+        for (uint8_t run = 0; run < BENCHMARK_RUNS; run++)           \
+        {                                                            \
+            prepare;                                                 \
+            startCycleCounter();                                     \
+            statement;                                               \
+            uint32_t cycles = stopCycleCounter() - counterOverhead;  \
+            minCycles = min(minCycles, cycles);                      \
+            maxCycles = max(maxCycles, cycles);                      \
+        }                                                            \
+        report(F(name), minCycles, maxCycles);                       \
+    }
+
+#define BENCHMARK(name, statement) BENCHMARK_PREPARED(name, , statement)
+
+void runBenchmarks()
+{
+    power_timer1_enable();
+
+    startCycleCounter();
+    counterOverhead = stopCycleCounter();
+
+    char str[7];
+    Zone &zone = zones[0];
+
+    BENCHMARK("formatTemperature", formatTemperature(zone.temperature, false, str, sizeof(str)));
+    BENCHMARK("formatHumidity", formatHumidity(zone.humidity, str, sizeof(str)));
+    BENCHMARK("toggleHeater", toggleHeater(zone));
+    BENCHMARK("MainScreenMenu::render", mainScreenMenu.render());
+    mainMenu.enter();
+    BENCHMARK("MainSettingsMenu::render", mainMenu.render());
+    // A pass right after setup has nothing due, every measured one reads a zone, switches its heater and redraws
+    BENCHMARK_PREPARED("loop", loopMakeDue(millis()), loopPass(millis(), false, false, false));
+
+    power_timer1_disable();
+    Serial.println(F("{\"benchmark\":\"done\"}"));
+}
+
+#endif // DRYBOX_BENCHMARK
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#include "calibration.h"
+
+static const char nameNaCl[] PROGMEM = "NaCl";
+static const char nameMgCl2[] PROGMEM = "MgCl2";
+static const char nameK2CO3[] PROGMEM = "K2CO3";
+static const char nameLiCl[] PROGMEM = "LiCl";
+
+const SaltReference saltReferences[SALT_REFERENCE_COUNT] = {
+    {nameNaCl, 7529},
+    {nameMgCl2, 3278},
+    {nameK2CO3, 4316},
+    {nameLiCl, 1130},
+};
+
+bool calibrationValid(const Calibration &calibration)
+{
+    return calibration.gain >= CALIBRATION_MIN_GAIN && calibration.gain <= CALIBRATION_MAX_GAIN &&
+           abs(calibration.offset) <= CALIBRATION_MAX_OFFSET;
+}
+
+bool calibrationFromPoint(Calibration &calibration, int16_t raw, int16_t reference)
+{
+    Calibration result;
+    result.offset = reference - raw;
+    if (!calibrationValid(result))
+        return false;
+
+    calibration = result;
+    return true;
+}
+
+bool calibrationFromPoints(Calibration &calibration, int16_t raw1, int16_t reference1, int16_t raw2, int16_t reference2)
+{
+    if (abs(raw2 - raw1) < CALIBRATION_MIN_SPAN)
+        return false;
+
+    // Float is fine here, this runs once per calibration and not per sample
+    float gain = (float)(reference2 - reference1) / (raw2 - raw1);
+    if (gain * CALIBRATION_UNITY < CALIBRATION_MIN_GAIN || gain * CALIBRATION_UNITY > CALIBRATION_MAX_GAIN)
+        return false;
+
+    Calibration result;
+    result.gain = lround(gain * CALIBRATION_UNITY);
+    result.offset = 0;
+    result.offset = reference1 - calibrationApply(result, raw1); // Exact at the first point after rounding the gain
+    if (!calibrationValid(result))
+        return false;
+
+    calibration = result;
+    return true;
+}
+
+void calibrationLoad(int address, Calibration &calibration)
+{
+    EEPROM.get(address, calibration);
+    if (calibrationValid(calibration))
+        return;
+
+    // Older firmware kept a float offset in the same 4 bytes, only floats too small to matter read as a valid gain and offset
+    float legacyOffset;
+    EEPROM.get(address, legacyOffset);
+    calibration = Calibration();
+    if (legacyOffset >= -CALIBRATION_MAX_OFFSET / 100.0 && legacyOffset <= CALIBRATION_MAX_OFFSET / 100.0)
+        calibration.offset = lround(legacyOffset * 100);
+}
\ No newline at end of file
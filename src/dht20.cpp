@@ -0,0 +1,71 @@
+#include <Wire.h>
+
+#include "dht20.h"
+#include "power.h"
+
+void Dht20ZoneSensor::attach(DFRobot_DHT20 *dht20, uint8_t muxChannel)
+{
+    this->dht20 = dht20;
+    this->muxChannel = muxChannel;
+}
+
+bool Dht20ZoneSensor::select()
+{
+    if (muxChannel == NO_MUX_CHANNEL)
+        return true;
+
+    Wire.beginTransmission(TCA9548A_ADDRESS);
+    Wire.write(1 << muxChannel);
+    return Wire.endTransmission() == 0;
+}
+
+bool Dht20ZoneSensor::begin()
+{
+    return select() && dht20->begin() == 0;
+}
+
+// CRC-8 over the status and data bytes, polynomial x^8 + x^5 + x^4 + 1, initial value 0xFF
+static uint8_t crc8(const uint8_t *data, uint8_t length)
+{
+    uint8_t crc = 0xFF;
+    while (length--)
+    {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+    }
+    return crc;
+}
+
+bool Dht20ZoneSensor::read(float &temperature, float &humidity)
+{
+    if (!select())
+        return false;
+
+    // Trigger a measurement
+    Wire.beginTransmission(DHT20_ADDRESS);
+    Wire.write(0xAC);
+    Wire.write(0x33);
+    Wire.write(0x00);
+    if (Wire.endTransmission() != 0)
+        return false;
+    idleFor(DHT20_MEASURE_TIME);
+
+    // Status, 20 bits humidity, 20 bits temperature, CRC
+    uint8_t data[7];
+    if (Wire.requestFrom((uint8_t)DHT20_ADDRESS, (uint8_t)sizeof(data)) != sizeof(data))
+        return false;
+    for (uint8_t i = 0; i < sizeof(data); i++)
+        data[i] = Wire.read();
+
+    if ((data[0] & DHT20_STATUS_BUSY) || !(data[0] & DHT20_STATUS_CALIBRATED))
+        return false;
+    if (crc8(data, 6) != data[6])
+        return false;
+
+    uint32_t rawHumidity = (uint32_t)data[1] << 12 | (uint32_t)data[2] << 4 | data[3] >> 4;
+    uint32_t rawTemperature = (uint32_t)(data[3] & 0x0F) << 16 | (uint32_t)data[4] << 8 | data[5];
+    humidity = rawHumidity * 100.0 / (1UL << 20);              // Relative humidity in %
+    temperature = rawTemperature * 200.0 / (1UL << 20) - 50;  // Degrees Celsius
+    return true;
+}
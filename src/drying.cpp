@@ -0,0 +1,108 @@
+#include "drying.h"
+#include "zone.h"
+
+#define DRYING_WEIGHT 256 // Weight of the newest point, 8 fractional bits
+#define DRYING_SLOPE_SHIFT 10
+#define DRYING_STALL_SLOPE ((int32_t)(DRYING_STALL_RATE * 10 * (1L << DRYING_SLOPE_SHIFT) * DRYING_POINT_INTERVAL / 3600000UL))
+
+// Exponentially weighted least-squares line through the humidity points, kept as running sums.
+// x is the age of a point in points, so ageing all points by one is a shift of the sums instead of a pass over a window.
+struct DryingFit
+{
+    int32_t s0 = 0;  // Sum of w
+    int32_t sx = 0;  // Sum of w * x
+    int32_t sxx = 0; // Sum of w * x * x
+    int32_t sy = 0;  // Sum of w * y, y in 0.1 %
+    int32_t sxy = 0; // Sum of w * x * y
+    int32_t slope = 0; // Fall per point in 0.1 % << DRYING_SLOPE_SHIFT, positive while drying
+    int16_t level = 0; // Fitted humidity of the newest point in 0.1 %
+    uint8_t points = 0;
+    unsigned long lastPointTime = 0;
+};
+
+static DryingFit fits[ZONE_COUNT];
+
+static inline void decay(int32_t &sum)
+{
+    sum -= sum >> DRYING_DECAY_SHIFT;
+}
+
+// Every point gets one older: (x + 1)^2 = x^2 + 2x + 1, then all weights decay
+static void age(DryingFit &fit)
+{
+    fit.sxx += 2 * fit.sx + fit.s0;
+    fit.sx += fit.s0;
+    fit.sxy += fit.sy;
+    decay(fit.s0);
+    decay(fit.sx);
+    decay(fit.sxx);
+    decay(fit.sy);
+    decay(fit.sxy);
+}
+
+static void addPoint(DryingFit &fit, int16_t humidity)
+{
+    // The new point has x = 0, so only the sums without x change
+    fit.s0 += DRYING_WEIGHT;
+    fit.sy += (int32_t)DRYING_WEIGHT * humidity;
+    if (fit.points < 255)
+        fit.points++;
+
+    int64_t denominator = (int64_t)fit.s0 * fit.sxx - (int64_t)fit.sx * fit.sx;
+    if (denominator <= 0)
+        return;
+
+    // Regression slope against the age, so a falling humidity gives a positive slope
+    int64_t numerator = (int64_t)fit.s0 * fit.sxy - (int64_t)fit.sx * fit.sy;
+    fit.slope = (numerator << DRYING_SLOPE_SHIFT) / denominator;
+    fit.level = (((int64_t)fit.sy << DRYING_SLOPE_SHIFT) - (int64_t)fit.slope * fit.sx) / ((int64_t)fit.s0 << DRYING_SLOPE_SHIFT);
+}
+
+void dryingSample(uint8_t zone, float humidity, unsigned long currentTime)
+{
+    DryingFit &fit = fits[zone];
+    int16_t value = constrain(lround(humidity * 10), 0, 1000);
+
+    if (fit.points == 0)
+    {
+        addPoint(fit, value);
+        fit.lastPointTime = currentTime;
+        return;
+    }
+
+    unsigned long elapsed = (currentTime - fit.lastPointTime) / DRYING_POINT_INTERVAL;
+    if (elapsed == 0)
+        return;
+    if (elapsed > DRYING_MAX_GAP)
+    {
+        fit = DryingFit(); // Too long without readings, the old trend no longer applies
+        addPoint(fit, value);
+        fit.lastPointTime = currentTime;
+        return;
+    }
+
+    // Points missed while no reading came in only age the fit
+    for (unsigned long i = 0; i < elapsed; i++)
+        age(fit);
+    addPoint(fit, value);
+    fit.lastPointTime += elapsed * DRYING_POINT_INTERVAL;
+}
+
+DryingState dryingEstimate(uint8_t zone, uint16_t targetHumidity, uint16_t &minutes)
+{
+    const DryingFit &fit = fits[zone];
+    int32_t remaining = fit.level - (int32_t)targetHumidity * 10;
+
+    if (fit.points < DRYING_MIN_POINTS)
+        return DryingUnknown;
+    if (remaining <= 0)
+        return DryingDone;
+    if (fit.slope < 0)
+        return DryingUnknown; // Getting wetter, e.g. the lid was opened, there is nothing to project
+    if (fit.slope < DRYING_STALL_SLOPE)
+        return DryingStalled;
+
+    uint32_t pointsLeft = ((uint32_t)remaining << DRYING_SLOPE_SHIFT) / fit.slope;
+    minutes = min(pointsLeft * DRYING_POINT_INTERVAL / 60000UL, (uint32_t)DRYING_MAX_ETA);
+    return DryingProgress;
+}
\ No newline at end of file
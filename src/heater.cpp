@@ -0,0 +1,153 @@
+#include <avr/power.h>
+
+#include "drybox.h"
+#include "heater.h"
+#include "interlock.h"
+
+#if HEATER_DRIVE_MODE == HEATER_DRIVE_PWM
+#define TIMER1_PRESCALER (_BV(CS11))                           // clk/8
+#define TIMER1_TOP (F_CPU / 8 / 1000 - 1)                      // 1 kHz
+#endif
+
+#if HEATER_SOFT_START_MS > 0 && HEATER_SOFT_START_MS < INTERLOCK_TICK_MS
+#error "HEATER_SOFT_START_MS is shorter than one interlock tick, use 0 to disable the soft start"
+#endif
+
+#if HEATER_SOFT_START_MS > 0
+#define RAMP_STEP ((uint16_t)(255UL * 256 * INTERLOCK_TICK_MS / HEATER_SOFT_START_MS)) // 8.8 fixed point per tick
+#else
+#define RAMP_STEP 0xFFFF
+#endif
+
+#define SOFT_WINDOW_TICKS (4000 / INTERLOCK_TICK_MS) // Time-proportional window
+
+// Written by the loop, read by the interrupt
+static volatile uint8_t targetDuty[ZONE_COUNT];
+// Interrupt only, 8.8 fixed point so slow ramps still advance every tick
+static uint16_t currentDuty[ZONE_COUNT];
+static uint8_t appliedDuty[ZONE_COUNT];
+// Interrupt only, the time-proportioned pins
+static uint16_t softOnTicks[ZONE_COUNT]; // On time within the window
+static uint16_t softPhase = 0;
+static uint8_t softDriven = 0; // One bit per zone
+static uint8_t softLevel = 0;
+
+#if HEATER_DRIVE_MODE == HEATER_DRIVE_PWM
+static void applyTimer1Duty(uint8_t pin, uint8_t timer, uint8_t duty)
+{
+    if (duty == 0)
+    {
+        // The compare value loads at the next period, so the output is low there when the pin is connected again
+        if (timer == TIMER1A)
+            OCR1A = 0;
+        else
+            OCR1B = 0;
+        digitalWrite(pin, LOW); // Also disconnects the pin from Timer1
+        return;
+    }
+
+    // Full duty uses OCR = TOP, which keeps the output constantly high
+    uint16_t compare = duty == 255 ? TIMER1_TOP : (uint16_t)((uint32_t)TIMER1_TOP * duty / 255);
+    if (timer == TIMER1A)
+    {
+        OCR1A = compare;
+        TCCR1A |= _BV(COM1A1);
+    }
+    else
+    {
+        OCR1B = compare;
+        TCCR1A |= _BV(COM1B1);
+    }
+}
+#endif
+
+static void applyDuty(uint8_t zone, uint8_t duty)
+{
+#if HEATER_DRIVE_MODE == HEATER_DRIVE_PWM
+    uint8_t pin = zones[zone].heaterPin;
+    uint8_t timer = digitalPinToTimer(pin);
+    if (timer == TIMER1A || timer == TIMER1B)
+    {
+        applyTimer1Duty(pin, timer, duty);
+        return;
+    }
+#endif
+
+    // A 4 s window is not run from Timer1: its compare registers only load at the start of a window, so a ramp
+    // would advance in one or two steps, and a pin connected mid-window would carry on at the previous duty
+    softDriven |= _BV(zone);
+    softOnTicks[zone] = (uint32_t)SOFT_WINDOW_TICKS * duty / 255; // Full duty stays on all window
+}
+
+void heaterDriverInit()
+{
+#if HEATER_DRIVE_MODE == HEATER_DRIVE_PWM
+    power_timer1_enable();
+
+    // Fast PWM with ICR1 as TOP (mode 14), outputs are connected once a heater is switched on
+    TCCR1B = 0;
+    TIMSK1 = 0;
+    TCCR1A = _BV(WGM11);
+    ICR1 = TIMER1_TOP;
+    TCNT1 = 0;
+    TCCR1B = _BV(WGM13) | _BV(WGM12) | TIMER1_PRESCALER;
+#endif
+}
+
+void heaterDrive(uint8_t zone, uint8_t duty)
+{
+    targetDuty[zone] = min(duty, HEATER_FULL_DUTY);
+}
+
+uint8_t heaterDuty(uint8_t zone)
+{
+    return appliedDuty[zone];
+}
+
+void heaterDriverTick()
+{
+    if (++softPhase >= SOFT_WINDOW_TICKS)
+        softPhase = 0;
+
+    for (uint8_t i = 0; i < ZONE_COUNT; i++)
+    {
+        uint16_t target = (uint16_t)targetDuty[i] << 8;
+        if (currentDuty[i] > target)
+            currentDuty[i] = target; // Switching down is never delayed
+        else if (target - currentDuty[i] > RAMP_STEP)
+            currentDuty[i] += RAMP_STEP;
+        else
+            currentDuty[i] = target;
+
+        uint8_t duty = currentDuty[i] >> 8;
+        if (duty != appliedDuty[i])
+        {
+            applyDuty(i, duty);
+            appliedDuty[i] = duty;
+        }
+
+        if (softDriven & _BV(i))
+        {
+            // Windows of the zones are staggered so their heaters do not all switch on at the same moment
+            uint16_t phase = softPhase + i * (SOFT_WINDOW_TICKS / ZONE_COUNT);
+            if (phase >= SOFT_WINDOW_TICKS)
+                phase -= SOFT_WINDOW_TICKS;
+            bool on = phase < softOnTicks[i];
+            if (on != (bool)(softLevel & _BV(i)))
+            {
+                digitalWrite(zones[i].heaterPin, on ? HIGH : LOW);
+                softLevel ^= _BV(i);
+            }
+        }
+    }
+}
+
+void heaterForceOff(uint8_t zone)
+{
+    targetDuty[zone] = 0;
+    currentDuty[zone] = 0;
+    appliedDuty[zone] = 0;
+    applyDuty(zone, 0);
+    softLevel &= ~_BV(zone);
+    digitalWrite(zones[zone].heaterPin, LOW);
+}
\ No newline at end of file
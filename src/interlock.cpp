@@ -0,0 +1,189 @@
+#include <avr/interrupt.h>
+#include <avr/power.h>
+#include <avr/wdt.h>
+#include <util/atomic.h>
+
+#include "drybox.h"
+#include "heater.h"
+#include "interlock.h"
+
+#if SENSOR_MAX_INTERVAL + 2 * SENSOR_MIN_INTERVAL > SENSOR_STALE_TIMEOUT
+#error "SENSOR_MAX_INTERVAL leaves no room for a retry before the sensor is declared stale"
+#endif
+
+#define STALE_TICKS (SENSOR_STALE_TIMEOUT / INTERLOCK_TICK_MS)
+#define LOOP_STALL_TICKS (LOOP_STALL_TIMEOUT / INTERLOCK_TICK_MS)
+
+// Shared with the interrupt
+static volatile uint8_t faults[ZONE_COUNT];
+static volatile uint16_t sampleAge[ZONE_COUNT]; // Ticks since the last sample
+static volatile uint16_t loopAge = 0;           // Ticks since the last loop pass
+
+// Runaway tracking, only touched from the loop
+struct RunawayState
+{
+    bool primed = false;   // Got a sample since boot or the last clear
+    bool heating = false;
+    bool watching = false; // Heating far below the band, the temperature has to keep rising
+    bool dropped = false;  // The watch started because the temperature fell out of the band while heating
+    float reference = 0;   // Watching: temperature at the last sufficient rise, cooling: lowest recent temperature
+    unsigned long since = 0;
+};
+static RunawayState runaway[ZONE_COUNT];
+
+#ifdef __AVR__
+// A watchdog reset leaves the watchdog running with its shortest timeout, 16 ms. This runs from .init3, before the
+// C runtime clears memory and runs the constructors, so the watchdog is off before anything slow can happen.
+void disableWatchdogEarly() __attribute__((naked, used, section(".init3")));
+void disableWatchdogEarly()
+{
+    MCUSR = 0;
+    wdt_disable();
+}
+#endif
+
+ISR(TIMER2_COMPA_vect)
+{
+    bool loopStalled = loopAge >= LOOP_STALL_TICKS;
+    if (!loopStalled)
+        loopAge++;
+
+    for (uint8_t i = 0; i < ZONE_COUNT; i++)
+    {
+        if (sampleAge[i] < STALE_TICKS)
+            sampleAge[i]++;
+        else
+            faults[i] |= FaultStaleSensor;
+
+        if (loopStalled)
+            faults[i] |= FaultLoopStall;
+
+        if (faults[i])
+            heaterForceOff(i);
+    }
+
+    heaterDriverTick();
+}
+
+void interlockInit()
+{
+    power_timer2_enable();
+
+    // CTC mode, 16 MHz / 1024 / 156 = 100 Hz
+    TCCR2A = _BV(WGM21);
+    TCCR2B = _BV(CS22) | _BV(CS21) | _BV(CS20);
+    OCR2A = F_CPU / 1024 / (1000 / INTERLOCK_TICK_MS) - 1;
+    TCNT2 = 0;
+    TIMSK2 = _BV(OCIE2A);
+
+    // Backstop for hangs with interrupts disabled. The heater pins are high impedance while in reset, so the heater
+    // driver needs an external pull-down on its input to stay off.
+    wdt_enable(WDTO_2S);
+}
+
+void interlockKick()
+{
+    wdt_reset();
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        loopAge = 0;
+        for (uint8_t i = 0; i < ZONE_COUNT; i++)
+            faults[i] &= ~FaultLoopStall;
+    }
+}
+
+void interlockSample(uint8_t zone, float temperature, float rawTemperature, bool heaterRunning,
+                     unsigned long currentTime)
+{
+    uint8_t newFaults = 0;
+
+    if (max(temperature, rawTemperature) > ABSOLUTE_MAX_TEMP)
+        newFaults |= FaultOverTemperature;
+
+    RunawayState &state = runaway[zone];
+    float switchOnAt, switchOffAt;
+    zoneSwitchPoints(zones[zone], switchOnAt, switchOffAt);
+    bool farBelow = temperature < switchOnAt - RUNAWAY_WATCH_MARGIN;
+
+    if (!state.primed || heaterRunning != state.heating)
+    {
+        state.primed = true;
+        state.heating = heaterRunning;
+        state.watching = heaterRunning && farBelow;
+        state.dropped = false;
+        state.reference = temperature;
+        state.since = currentTime;
+    }
+    else if (heaterRunning)
+    {
+        // Like Marlin's watch period: the rise is only demanded while the target is still far off, close to the
+        // band the heater may legitimately crawl. Falling out of the band while heating starts a shorter watch.
+        if (!farBelow)
+        {
+            state.watching = false;
+        }
+        else if (!state.watching)
+        {
+            state.watching = true;
+            state.dropped = true;
+            state.reference = temperature;
+            state.since = currentTime;
+        }
+        else if (temperature >= state.reference + RUNAWAY_MIN_RISE)
+        {
+            state.reference = temperature;
+            state.since = currentTime;
+        }
+        else if (currentTime - state.since > (state.dropped ? RUNAWAY_DROP_WINDOW : RUNAWAY_HEATING_WINDOW))
+        {
+            newFaults |= FaultRunawayHeating;
+        }
+    }
+    else
+    {
+        // Only a fast rise counts, ambient drifting up over hours must not trip it
+        if (temperature < state.reference || currentTime - state.since > RUNAWAY_HEATING_WINDOW)
+        {
+            state.reference = temperature;
+            state.since = currentTime;
+        }
+        else if (temperature > state.reference + RUNAWAY_COOLING_RISE)
+        {
+            newFaults |= FaultRunawayCooling;
+        }
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        sampleAge[zone] = 0;
+        faults[zone] = (faults[zone] & ~FaultStaleSensor) | newFaults;
+    }
+}
+
+uint8_t interlockFaults(uint8_t zone)
+{
+    return faults[zone];
+}
+
+void interlockClear(uint8_t zone)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        faults[zone] &= FaultStaleSensor | FaultLoopStall; // These clear themselves once the cause is gone
+    }
+    runaway[zone] = RunawayState();
+}
+
+const __FlashStringHelper *interlockFaultName(uint8_t faults)
+{
+    if (faults & FaultOverTemperature)
+        return F("OVERTEMP");
+    if (faults & (FaultRunawayHeating | FaultRunawayCooling))
+        return F("RUNAWAY");
+    if (faults & FaultStaleSensor)
+        return F("SENSOR");
+    if (faults & FaultLoopStall)
+        return F("STALL");
+    return F("");
+}
\ No newline at end of file
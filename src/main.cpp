@@ -21,19 +21,31 @@ REQUIRES the following Arduino libraries:
 #include "drybox.h"
 #include "screen.h"
 #include "menu.h"
+#include "power.h"
+#include "benchmark.h"
+#include "sram.h"
+#include "interlock.h"
+#include "thermal.h"
+#include "heater.h"
+#include "trace.h"
+#include "drying.h"
+#include "dht20.h"
 
 #define ON_OFF_BTN 6
 #define UP_BTN 7
 #define DOWN_BTN 8
 #define HEATER_CTRL_PIN 10
 
+#ifndef ZONE_HEATER_PINS
+#define ZONE_HEATER_PINS {HEATER_CTRL_PIN}
+#endif
+
 DFRobot_DHT20 dht20;
+Dht20ZoneSensor zoneSensors[ZONE_COUNT];
 
 unsigned long currentTime = 0; // Current time in milliseconds
 
 unsigned long firstOnOffBtnPress = ULONG_MAX;
-bool heaterOn = false; // Indicates if the heater is currently on
-bool heaterRunning = false;
 DeviceState deviceState = MainScreen;
 MenuOption *menu = &mainScreenMenu;
 
@@ -41,68 +53,115 @@ ButtonPress onOffButtonPress;
 ButtonPress upButtonPress;
 ButtonPress downButtonPress;
 
-float TargetTemp = 45;
-unsigned short TargetHumidity = 30;
-float TemperatureCalibration = 0.0;              // Calibration offset for temperature
-float HumidityCalibration = 0.0;                 // Calibration offset for humidity
-float Temperature = 255.0;                       // Default value for temperature, will be updated by the sensor
-float Humidity = 99.0;                           // Default value for humidity, will be updated by the sensor
+Zone zones[ZONE_COUNT];
+uint8_t activeZone = 0;
 TemperatureUnit Unit = TemperatureUnit::Celsius; // Default temperature unit
 
-void toggleHeater()
+static unsigned long lastSensorUpdate = 0; // Last zone read, the next one is staggered from it
+static unsigned long lastRender = 0;       // Last frame pushed to the display
+
+void toggleHeater(Zone &zone)
 {
-  short heaterState = LOW;
-  if (heaterOn)
+  uint8_t zoneIndex = &zone - zones;
+  uint8_t faults = interlockFaults(zoneIndex);
+  bool heaterRunning = !memoryAlarm && !faults && zoneHeaterDemand(zone); // Heaters stay off once memory ran low or on a fault
+
+  if (heaterRunning != zone.heaterRunning)
   {
-    if (Humidity + HumidityCalibration > TargetHumidity)
-    {
-      if (Temperature + TemperatureCalibration < TargetTemp - 1.5)
-      {
-        Serial.println(F("Humidity is too high or temperature is too low"));
-        // If the temperature is below the target temperature, turn on the heater
-        heaterState = HIGH;
-        heaterRunning = true;
-      }
-      else if (Temperature + TemperatureCalibration > TargetTemp + 1.5)
-      {
-        Serial.println(F("Temperature is too high, turning off heater"));
-        // If the temperature is above the target temperature, turn off the heater
-        heaterState = LOW;
-        heaterRunning = false;
-      }
-      else
-      {
-        Serial.println(F("Heater is running, but conditions are not met to turn it on or off"));
-      }
-    }
-    else
+    Serial.print(F("Heater "));
+    Serial.print(zoneIndex);
+    Serial.println(heaterRunning ? F(" turned on, temperature is too low") : F(" turned off"));
+    if (faults)
     {
-      heaterState = LOW;     // Heater is off
-      heaterRunning = false; // Heater is off, not running
+      Serial.print(F("Interlock fault: "));
+      Serial.println(interlockFaultName(faults));
     }
+    traceHeater(zoneIndex, heaterRunning, currentTime);
   }
-  else
-  {
-    heaterState = LOW;     // Heater is off
-    heaterRunning = false; // Heater is off, not running
-  }
+  zone.heaterRunning = heaterRunning;
 
-  digitalWrite(HEATER_CTRL_PIN, heaterState);
+  heaterDrive(zoneIndex, heaterRunning ? HEATER_FULL_DUTY : 0);
 }
 
-void sensorUpdate(unsigned long currentTime)
+// Machine readable status line of a zone, collected by tools/aggregator:
+// $DBX,<zone>,<temperature 0.1C>,<humidity 0.1%>,<target temperature 0.1C>,<target humidity %>,<heater on>,<heater running>,<interlock faults>,<sample interval ms>
+void reportStatus(uint8_t zoneIndex)
 {
-  static unsigned long lastSensorUpdate = 0;
-
-  if (currentTime - lastSensorUpdate < 5000)
-    return; // Update sensor data every 5 seconds
+  const Zone &zone = zones[zoneIndex];
+
+  Serial.print(F("$DBX,"));
+  Serial.print(zoneIndex);
+  Serial.print(',');
+  Serial.print(lround(zone.temperature * 10));
+  Serial.print(',');
+  Serial.print(lround(zone.humidity * 10));
+  Serial.print(',');
+  Serial.print(lround(zone.targetTemp * 10));
+  Serial.print(',');
+  Serial.print(zone.targetHumidity);
+  Serial.print(',');
+  Serial.print(zone.heaterOn);
+  Serial.print(',');
+  Serial.print(zone.heaterRunning);
+  Serial.print(',');
+  Serial.print(interlockFaults(zoneIndex));
+  Serial.print(',');
+  Serial.println(zone.sampleInterval);
+}
 
-  Temperature = dht20.getTemperature(); // Get temperature in degrees Celcius
-  Humidity = dht20.getHumidity() * 100; // Get relative humidity
+// Reads the next zone that is due, returns false if none was
+bool sensorUpdate(unsigned long currentTime)
+{
+  // Zones are read one at a time, staggered so the I2C bus is never contended
+  uint8_t nextZone = zoneNextDue(zones, ZONE_COUNT, lastSensorUpdate, currentTime);
+  if (nextZone == ZONE_COUNT)
+    return false;
+
+  Zone &zone = zones[nextZone];
+  float lastTemperature = zone.temperature;
+  float lastHumidity = zone.humidity;
+  bool sampled = zoneSample(zone);
+  traceSample(nextZone, sampled, currentTime);
+  zone.lastSampleTime = currentTime;
+  if (sampled)
+  {
+    zoneAdaptInterval(zone, lastTemperature, lastHumidity, currentTime - zone.lastSensorUpdate);
 
-  toggleHeater();
+    // The interlock judges the sample against the heater state it was taken under
+    zone.lastSensorUpdate = currentTime;
+    interlockSample(nextZone, zone.temperature, zone.rawTemperature / 100.0, zone.heaterRunning, currentTime);
+    thermalLearn(nextZone, zone.temperature, zone.heaterRunning);
+    dryingSample(nextZone, zone.humidity, currentTime);
+  }
+  else
+  {
+    zone.sampleInterval = SENSOR_MIN_INTERVAL; // Retry soon, before the interlock declares the sensor stale
+  }
+  toggleHeater(zone);
+  reportStatus(nextZone);
 
   lastSensorUpdate = currentTime;
+  return true;
+}
+
+// First reading of every zone at boot, all under the one time stamp so a trace replays it as one pass
+void sampleAllZones(unsigned long time)
+{
+  currentTime = time;
+  traceStart(time);
+
+  for (uint8_t i = 0; i < ZONE_COUNT; i++)
+  {
+    bool sampled = zoneSample(zones[i]);
+    traceSample(i, sampled, time);
+    zones[i].lastSampleTime = time;
+    if (sampled)
+    {
+      zones[i].lastSensorUpdate = time;
+      interlockSample(i, zones[i].temperature, zones[i].rawTemperature / 100.0, zones[i].heaterRunning, time);
+    }
+    toggleHeater(zones[i]);
+  }
 }
 
 void setup()
@@ -113,13 +172,31 @@ void setup()
   pinMode(ON_OFF_BTN, INPUT_PULLUP);
   pinMode(UP_BTN, INPUT_PULLUP);
   pinMode(DOWN_BTN, INPUT_PULLUP);
-  pinMode(HEATER_CTRL_PIN, OUTPUT);
+  const uint8_t heaterPins[ZONE_COUNT] = ZONE_HEATER_PINS;
+  for (uint8_t i = 0; i < ZONE_COUNT; i++)
+  {
+    zones[i].heaterPin = heaterPins[i];
+    pinMode(heaterPins[i], OUTPUT);
+  }
 
-  // Check if sensor and display are working
-  if (dht20.begin())
+  // Power down unused peripherals and let the buttons wake the MCU from idle sleep
+  powerInit();
+  wakeOnPin(ON_OFF_BTN);
+  wakeOnPin(UP_BTN);
+  wakeOnPin(DOWN_BTN);
+
+  // Check if sensors and display are working, with more than one zone every sensor sits behind the multiplexer
+  Wire.begin();
+  for (uint8_t i = 0; i < ZONE_COUNT; i++)
   {
-    Serial.println("Initialize sensor failed");
-    delay(1000);
+    zoneSensors[i].attach(&dht20, ZONE_COUNT > 1 ? i : NO_MUX_CHANNEL);
+    zones[i].sensor = &zoneSensors[i];
+    if (!zones[i].sensor->begin())
+    {
+      Serial.print(F("Initialize sensor failed for zone "));
+      Serial.println(i);
+      delay(1000);
+    }
   }
   if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS))
   {
@@ -127,15 +204,27 @@ void setup()
     delay(1000);
   }
 
-  EEPROM.get(0, TargetTemp);             // Load target temperature from EEPROM
-  EEPROM.get(4, TargetHumidity);         // Load target humidity from EEPROM
-  EEPROM.get(8, TemperatureCalibration); // Load temperature calibration from EEPROM
-  EEPROM.get(12, HumidityCalibration);   // Load humidity calibration from EEPROM
+  for (uint8_t i = 0; i < ZONE_COUNT; i++)
+  {
+    int address = zoneEepromAddress(i);
+    EEPROM.get(address, zones[i].targetTemp);                  // Load target temperature from EEPROM
+    EEPROM.get(address + 4, zones[i].targetHumidity);          // Load target humidity from EEPROM
+    calibrationLoad(address + 8, zones[i].temperatureCalibration); // Load temperature calibration from EEPROM
+    calibrationLoad(address + 12, zones[i].humidityCalibration);   // Load humidity calibration from EEPROM
+  }
   EEPROM.get(16, Unit);
+  thermalLoad();
 
   // drawLogo();
   // delay(1200);
-  sensorUpdate(millis());
+  sampleAllZones(millis());
+
+#ifdef DRYBOX_BENCHMARK
+  runBenchmarks();
+#endif
+
+  heaterDriverInit();
+  interlockInit();
 }
 
 void maybeUpdateEEPROM()
@@ -145,11 +234,15 @@ void maybeUpdateEEPROM()
   if (currentTime - lastEEPROMUpdate < 60000) // Update EEPROM every 60 seconds
     return;
 
-  EEPROM.put(0, TargetTemp);             // Save target temperature to EEPROM
-  EEPROM.put(4, TargetHumidity);         // Save target humidity to EEPROM
-  EEPROM.put(8, TemperatureCalibration); // Save temperature calibration to EEPROM
-  EEPROM.put(12, HumidityCalibration);   // Save humidity calibration to EEPROM
-  EEPROM.put(16, Unit);                  // Save temperature display setting to EEPROM
+  for (uint8_t i = 0; i < ZONE_COUNT; i++)
+  {
+    int address = zoneEepromAddress(i);
+    EEPROM.put(address, zones[i].targetTemp);                  // Save target temperature to EEPROM
+    EEPROM.put(address + 4, zones[i].targetHumidity);          // Save target humidity to EEPROM
+    EEPROM.put(address + 8, zones[i].temperatureCalibration);  // Save temperature calibration to EEPROM
+    EEPROM.put(address + 12, zones[i].humidityCalibration);    // Save humidity calibration to EEPROM
+  }
+  EEPROM.put(16, Unit); // Save temperature display setting to EEPROM
 
   lastEEPROMUpdate = currentTime;
 }
@@ -177,6 +270,7 @@ void buttonMenu(ButtonPress onOffPress, ButtonPress upPress, ButtonPress downPre
 bool b1WasPressed = false;
 bool b2WasPressed = false;
 bool b3WasPressed = false;
+bool swallowButtons = false; // Set while the press that woke up the display is still held
 
 ButtonPress buttonClickHandler(int buttonState, bool &buttonPressed, unsigned long &firstPressTime, unsigned long currentTime, unsigned long delayTime = 1000)
 {
@@ -215,24 +309,83 @@ ButtonPress buttonClickHandler(int buttonState, bool &buttonPressed, unsigned lo
   }
 }
 
-void loop()
+// One pass of the superloop without the idle wait, so it can be benchmarked and replayed on its own.
+// Time and button states are passed in, so a pass depends on nothing but its inputs and the state before it.
+void loopPass(unsigned long now, bool b1, bool b2, bool b3)
 {
-  currentTime = millis();
+  static DeviceState lastDeviceState = MainScreen;
 
-  bool b1 = digitalRead(ON_OFF_BTN) == LOW;
-  bool b2 = digitalRead(UP_BTN) == LOW;
-  bool b3 = digitalRead(DOWN_BTN) == LOW;
+  currentTime = now;
+  interlockKick();
+  traceButtons(b1, b2, b3, currentTime);
+
+  // The press that wakes up a dimmed or blank display only wakes it, it is not passed to the menu
+  if ((b1 || b2 || b3) && displayWake(currentTime))
+  {
+    swallowButtons = true;
+  }
+  if (swallowButtons)
+  {
+    swallowButtons = b1 || b2 || b3;
+    b1 = b2 = b3 = false;
+    b1WasPressed = b2WasPressed = b3WasPressed = false;
+    firstOnOffBtnPress = ULONG_MAX;
+  }
 
   onOffButtonPress = buttonClickHandler(b1, b1WasPressed, firstOnOffBtnPress, currentTime);
   upButtonPress = buttonClickHandler(b2, b2WasPressed, currentTime, currentTime, 0);
   downButtonPress = buttonClickHandler(b3, b3WasPressed, currentTime, currentTime, 0);
 
-  sensorUpdate(currentTime);
+  bool changed = sensorUpdate(currentTime) || b1 || b2 || b3 || onOffButtonPress != ButtonPress::None ||
+                 upButtonPress != ButtonPress::None || downButtonPress != ButtonPress::None;
+  if (maybeCheckMemory(currentTime))
+  {
+    Serial.println(F("Free memory below alarm threshold, switching heaters off"));
+    for (uint8_t i = 0; i < ZONE_COUNT; i++)
+    {
+      toggleHeater(zones[i]);
+    }
+  }
   buttonMenu(onOffButtonPress, upButtonPress, downButtonPress);
+  if (menu->tick())
+  {
+    changed = true;
+  }
+  if (deviceState != lastDeviceState)
+  {
+    traceMenu(deviceState, currentTime);
+    lastDeviceState = deviceState;
+    changed = true;
+  }
 
-  menu->render();
+  displayIdleUpdate(currentTime);
+  // Pushing a frame keeps the CPU awake for most of the pass, so unchanged frames are not pushed every pass.
+  // No point in pushing any to a display that is switched off.
+  if (displayPower != DisplayOff && (changed || currentTime - lastRender >= DISPLAY_REFRESH_INTERVAL))
+  {
+    menu->render();
+    lastRender = currentTime;
+  }
 
   maybeUpdateEEPROM();
+  maybeSaveThermal(currentTime);
+}
+
+#ifdef DRYBOX_BENCHMARK
+void loopMakeDue(unsigned long now)
+{
+  for (uint8_t i = 0; i < ZONE_COUNT; i++)
+  {
+    zones[i].lastSampleTime = now - zones[i].sampleInterval;
+  }
+  lastSensorUpdate = now - SENSOR_MIN_INTERVAL;
+  lastRender = now - DISPLAY_REFRESH_INTERVAL;
+}
+#endif
+
+void loop()
+{
+  loopPass(millis(), digitalRead(ON_OFF_BTN) == LOW, digitalRead(UP_BTN) == LOW, digitalRead(DOWN_BTN) == LOW);
 
-  delay(100); // Add a small delay to avoid overwhelming the loop
+  idleUntil(currentTime + 100); // Sleep until the next pass is due or a button is pressed
 }
\ No newline at end of file
@@ -3,12 +3,20 @@
 #include "drybox.h"
 #include "menu.h"
 #include "screen.h"
+#include "sram.h"
+#include "interlock.h"
+#include "drying.h"
 
 void MainScreenMenu::onOffShortPress()
 {
     Serial.print(F("Toggle heater on/off setting to: "));
-    heaterOn = !heaterOn;
-    Serial.println(heaterOn ? F("Heater ON") : F("Heater OFF"));
+    Zone &zone = zones[activeZone];
+    zone.heaterOn = !zone.heaterOn;
+    if (zone.heaterOn)
+    {
+        interlockClear(activeZone); // Switching on again acknowledges a latched fault
+    }
+    Serial.println(zone.heaterOn ? F("Heater ON") : F("Heater OFF"));
 }
 
 void MainScreenMenu::onOffLongPress()
@@ -29,9 +37,11 @@ void MainScreenMenu::upPress()
     {
         step = 5.0/9.0; // Adjust step for Fahrenheit
     }
-    TargetTemp = min(TargetTemp + step, 50); // Limit target temperature to a maximum of 50
+    Zone &zone = zones[activeZone];
+    zone.targetTemp = min(zone.targetTemp + step, 50); // Limit target temperature to a maximum of 50
+    zoneShownTime = currentTime; // Stay on this zone while it is being adjusted
     Serial.print(F("Target temperature set to: "));
-    Serial.println(TargetTemp);
+    Serial.println(zone.targetTemp);
 }
 
 void MainScreenMenu::downPress()
@@ -45,25 +55,71 @@ void MainScreenMenu::downPress()
     {
         step = 5.0/9.0; // Adjust step for Fahrenheit
     }
-    TargetTemp = max(TargetTemp - step, 0); // Limit target temperature to a minimum of 0
+    Zone &zone = zones[activeZone];
+    zone.targetTemp = max(zone.targetTemp - step, 0); // Limit target temperature to a minimum of 0
+    zoneShownTime = currentTime; // Stay on this zone while it is being adjusted
+}
+
+bool MainScreenMenu::tick()
+{
+    // With several zones the main screen cycles through them
+    if (ZONE_COUNT < 2 || currentTime - zoneShownTime < ZONE_CYCLE_TIME)
+        return false;
+
+    activeZone = (activeZone + 1) % ZONE_COUNT;
+    zoneShownTime = currentTime;
+    return true;
 }
 
 void MainScreenMenu::render()
 {
+    Zone &zone = zones[activeZone];
+
     prepareScreen();
     display.setTextSize(2);
     char tempStr[7];
-    formatTemperature(Temperature, false, tempStr, sizeof(tempStr));
+    formatTemperature(zone.temperature, false, tempStr, sizeof(tempStr));
     char humStr[6];
-    formatHumidity(Humidity, humStr, sizeof(humStr));
+    formatHumidity(zone.humidity, humStr, sizeof(humStr));
     display.setCursor(0, 24);
     display.print(tempStr);
-    if(heaterRunning)
+    if(zone.heaterRunning)
     {
         display.print('^');
     }
     display.setCursor(0, 48);
     display.print(humStr);
+    display.setTextSize(1);
+    display.print(' ');
+    if (memoryAlarm)
+    {
+        display.print(F("LOW MEM"));
+    }
+    else if (interlockFaults(activeZone))
+    {
+        display.print(interlockFaultName(interlockFaults(activeZone)));
+    }
+    else
+    {
+        uint16_t minutes;
+        switch (dryingEstimate(activeZone, zone.targetHumidity, minutes))
+        {
+        case DryingProgress: // Projected time to the target humidity, h:mm
+            display.print(F("ETA "));
+            display.print(minutes / 60);
+            display.print('h');
+            if (minutes % 60 < 10)
+                display.print('0');
+            display.print(minutes % 60);
+            break;
+        case DryingStalled: // Not getting drier while heating, desiccant needs replacing
+            if (zone.heaterOn)
+                display.print(F("STALL"));
+            break;
+        default:
+            break;
+        }
+    }
     display.display();
 }
 
@@ -97,6 +153,10 @@ void MainSettingsMenu::onOffShortPress()
         deviceState = SetHumidityCalibration;
         menu = &setHumidityCalibrationMenu;
         break;
+    case 5: // Diagnostics
+        deviceState = Diagnostics;
+        menu = &diagnosticsMenu;
+        break;
 
     default:
         break;
@@ -117,14 +177,14 @@ void MainSettingsMenu::upPress()
     Serial.println(F("Up button pressed in main menu"));
     pick--;
     if (pick < 0)
-        pick = 4; // Wrap around to the last option
+        pick = 5; // Wrap around to the last option
 }
 
 void MainSettingsMenu::downPress()
 {
     Serial.println(F("Down button pressed in main menu"));
     pick++;
-    if (pick > 4)
+    if (pick > 5)
         pick = 0; // Wrap around to the first option
 }
 
@@ -155,6 +215,9 @@ void MainSettingsMenu::render()
     case 4: // Set Humidity Calibration
         display.print(F("5) Hum Calib"));
         break;
+    case 5: // Diagnostics
+        display.print(F("6) Diagnostics"));
+        break;
     default:
         display.print(F("Invalid Option"));
         break;
@@ -203,13 +266,13 @@ void PickTemperatureDisplayMenu::render()
 void SetTargetTempMenu::enter()
 {
     Serial.println(F("Entering set target temperature menu"));
-    this->targetTemp = TargetTemp; // Reset to the current target temperature
+    this->targetTemp = zones[activeZone].targetTemp; // Reset to the current target temperature
 }
 
 void SetTargetTempMenu::onOffShortPress()
 {
     Serial.println(F("Exit set target temperature menu"));
-    TargetTemp = this->targetTemp; // Save the current target temperature
+    zones[activeZone].targetTemp = this->targetTemp; // Save the current target temperature
     deviceState = MainMenu;
     menu = &mainMenu;
 }
@@ -227,13 +290,13 @@ void SetTargetTempMenu::downPress()
 void SetTargetHumidityMenu::enter()
 {
     Serial.println(F("Entering set target humidity menu"));
-    this->targetHumidity = TargetHumidity; // Reset to the current target humidity
+    this->targetHumidity = zones[activeZone].targetHumidity; // Reset to the current target humidity
 }
 
 void SetTargetHumidityMenu::onOffShortPress()
 {
     Serial.println(F("Exit set target humidity menu"));
-    TargetHumidity = this->targetHumidity; // Save the current target humidity
+    zones[activeZone].targetHumidity = this->targetHumidity; // Save the current target humidity
     deviceState = MainMenu;
     menu = &mainMenu;
 }
@@ -248,54 +311,196 @@ void SetTargetHumidityMenu::downPress()
     this->targetHumidity = max(this->targetHumidity - 1, 0); // Limit target humidity to a minimum of 0
 }
 
-void SetTemperatureCalibrationMenu::enter()
+int16_t CalibrationMenu::rawReading()
+{
+    return humidity ? zones[activeZone].rawHumidity : zones[activeZone].rawTemperature;
+}
+
+void CalibrationMenu::startPoint()
 {
-    Serial.println(F("Entering set temperature calibration menu"));
-    this->temperatureCalibration = TemperatureCalibration; // Reset to default calibration value
+    failed = false;
+    if (humidity)
+    {
+        salt = step == CalibrationFirstPoint ? 0 : 1; // NaCl, then MgCl2, far apart for a good gain
+        reference = saltReferences[salt].humidity;
+    }
+    else
+    {
+        reference = lround(zones[activeZone].temperature * 10) * 10; // Start from the current reading, in 0.1 steps
+    }
 }
 
-void SetTemperatureCalibrationMenu::onOffShortPress()
+void CalibrationMenu::exit()
 {
-    Serial.println(F("Exit set temperature calibration menu"));
-    TemperatureCalibration = this->temperatureCalibration; // Save the current temperature calibration
     deviceState = MainMenu;
     menu = &mainMenu;
     menu->enter(); // Call enter to reset the menu state
 }
 
-void SetTemperatureCalibrationMenu::upPress()
+void CalibrationMenu::enter()
+{
+    Serial.println(humidity ? F("Entering humidity calibration") : F("Entering temperature calibration"));
+    step = CalibrationFirstPoint;
+    startPoint();
+}
+
+void CalibrationMenu::onOffShortPress()
+{
+    switch (step)
+    {
+    case CalibrationFirstPoint:
+        firstRaw = rawReading();
+        firstReference = reference;
+        step = CalibrationSecondPoint;
+        startPoint();
+        break;
+    case CalibrationSecondPoint:
+        failed = !calibrationFromPoints(result, firstRaw, firstReference, rawReading(), reference);
+        if (!failed)
+            step = CalibrationConfirm;
+        break;
+    case CalibrationConfirm:
+        Serial.println(F("Calibration saved"));
+        (humidity ? zones[activeZone].humidityCalibration : zones[activeZone].temperatureCalibration) = result;
+        zoneApplyCalibration(zones[activeZone]); // Show the corrected reading without waiting for the next sample
+        exit();
+        break;
+    }
+}
+
+void CalibrationMenu::onOffLongPress()
+{
+    if (step == CalibrationSecondPoint)
+    {
+        failed = !calibrationFromPoint(result, firstRaw, firstReference);
+        if (!failed)
+            step = CalibrationConfirm;
+        return;
+    }
+
+    Serial.println(F("Calibration cancelled"));
+    exit();
+}
+
+void CalibrationMenu::upPress()
 {
-    this->temperatureCalibration += 0.1; // Increase temperature calibration by 0.1
+    if (step == CalibrationConfirm)
+        return;
+
+    if (humidity)
+    {
+        salt = (salt + 1) % SALT_REFERENCE_COUNT;
+        reference = saltReferences[salt].humidity;
+    }
+    else
+    {
+        reference += 10; // 0.1 C
+    }
+}
+
+void CalibrationMenu::downPress()
+{
+    if (step == CalibrationConfirm)
+        return;
+
+    if (humidity)
+    {
+        salt = (salt + SALT_REFERENCE_COUNT - 1) % SALT_REFERENCE_COUNT;
+        reference = saltReferences[salt].humidity;
+    }
+    else
+    {
+        reference -= 10; // 0.1 C
+    }
 }
 
-void SetTemperatureCalibrationMenu::downPress()
+void CalibrationMenu::render()
 {
-    this->temperatureCalibration -= 0.1; // Decrease temperature calibration by 0.1
+    prepareScreen();
+    display.setCursor(0, 18);
+
+    if (step == CalibrationConfirm)
+    {
+        display.println(F("Save calibration?"));
+        display.print(F("Gain:   "));
+        display.println(result.gain / (float)CALIBRATION_UNITY, 4);
+        display.print(F("Offset: "));
+        display.println(result.offset / 100.0, 2);
+        display.print(F("OK save, hold cancel"));
+        display.display();
+        return;
+    }
+
+    display.print(humidity ? F("Hum") : F("Temp"));
+    display.print(F(" point "));
+    display.println(step == CalibrationFirstPoint ? 1 : 2);
+    display.print(F("Ref:    "));
+    display.print(reference / 100.0, 1);
+    display.print(humidity ? '%' : 'C');
+    if (humidity)
+    {
+        display.print(' ');
+        display.print((const __FlashStringHelper *)saltReferences[salt].name);
+    }
+    display.println();
+    display.print(F("Sensor: "));
+    display.println(rawReading() / 100.0, 2); // Uncalibrated, wait for it to settle before confirming
+    if (failed)
+        display.print(F("Points unusable"));
+    else
+        display.print(step == CalibrationFirstPoint ? F("OK set, hold cancel") : F("OK set, hold 1 point"));
+    display.display();
 }
 
-void SetHumidityCalibrationMenu::enter()
+void DiagnosticsMenu::enter()
 {
-    Serial.println(F("Entering set humidity calibration menu"));
-    this->humidityCalibration = HumidityCalibration; // Reset to default calibration value
+    Serial.println(F("Entering diagnostics page"));
+    memoryCheck(); // Show fresh figures right away
 }
 
-void SetHumidityCalibrationMenu::onOffShortPress()
+void DiagnosticsMenu::onOffShortPress()
 {
-    Serial.println(F("Exit set humidity calibration menu"));
-    HumidityCalibration = this->humidityCalibration; // Save the current humidity calibration
+    Serial.println(F("Exit diagnostics page"));
     deviceState = MainMenu;
     menu = &mainMenu;
     menu->enter(); // Call enter to reset the menu state
 }
 
-void SetHumidityCalibrationMenu::upPress()
+void DiagnosticsMenu::onOffLongPress()
 {
-    this->humidityCalibration += 0.1; // Increase humidity calibration by 0.1
+    onOffShortPress();
 }
 
-void SetHumidityCalibrationMenu::downPress()
+void DiagnosticsMenu::upPress()
 {
-    this->humidityCalibration -= 0.1; // Decrease humidity calibration by 0.1
+    memoryCheck();
+}
+
+void DiagnosticsMenu::downPress()
+{
+    memoryCheck();
+}
+
+void DiagnosticsMenu::render()
+{
+    prepareScreen();
+    display.setCursor(0, 18);
+    display.print(F("Free RAM:  "));
+    display.println(memoryStats.freeNow);
+    display.print(F("Min free:  "));
+    display.println(memoryStats.freeMinimum);
+    display.print(F("Heap:      "));
+    display.println(memoryStats.heapUsed);
+    display.print(F("Stack max: "));
+    display.println(memoryStats.stackPeak);
+    display.print(F("Sample:    "));
+    display.print(zones[activeZone].sampleInterval / 1000.0, 1);
+    display.println('s');
+    if (memoryAlarm)
+    {
+        display.print(F("LOW MEMORY, heater off"));
+    }
+    display.display();
 }
 
 MainScreenMenu mainScreenMenu = MainScreenMenu();
@@ -303,5 +508,6 @@ MainSettingsMenu mainMenu = MainSettingsMenu();
 PickTemperatureDisplayMenu pickTemperatureDisplayMenu = PickTemperatureDisplayMenu();
 SetTargetTempMenu setTargetTempMenu = SetTargetTempMenu();
 SetTargetHumidityMenu setTargetHumidityMenu = SetTargetHumidityMenu();
-SetTemperatureCalibrationMenu setTemperatureCalibrationMenu = SetTemperatureCalibrationMenu();
-SetHumidityCalibrationMenu setHumidityCalibrationMenu = SetHumidityCalibrationMenu();
+CalibrationMenu setTemperatureCalibrationMenu = CalibrationMenu(false);
+CalibrationMenu setHumidityCalibrationMenu = CalibrationMenu(true);
+DiagnosticsMenu diagnosticsMenu = DiagnosticsMenu();
@@ -0,0 +1,104 @@
+#include <avr/interrupt.h>
+#include <avr/power.h>
+#include <avr/sleep.h>
+
+#include "power.h"
+#include "screen.h"
+
+DisplayPower displayPower = DisplayAwake;
+
+static volatile bool buttonEvent = false;
+static unsigned long lastActivity = 0;
+
+// Any button edge ends the idle sleep early so presses are handled without waiting for the next pass
+ISR(PCINT0_vect)
+{
+    buttonEvent = true;
+}
+ISR(PCINT1_vect, ISR_ALIASOF(PCINT0_vect));
+ISR(PCINT2_vect, ISR_ALIASOF(PCINT0_vect));
+
+void powerInit()
+{
+    // ADC and analog comparator are not used, switch them off before gating their clocks
+    ADCSRA &= ~_BV(ADEN);
+    ACSR |= _BV(ACD);
+
+    // Timer0 (millis), Timer1 (heater outputs), Timer2 (interlock), TWI (display and sensor) and USART0 (Serial) stay powered
+    power_adc_disable();
+    power_spi_disable();
+
+    set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+void wakeOnPin(uint8_t pin)
+{
+    *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+    *digitalPinToPCICR(pin) |= _BV(digitalPinToPCICRbit(pin));
+}
+
+void idleUntil(unsigned long wakeTime)
+{
+    buttonEvent = false;
+
+    // Timer0 overflow wakes us up every ~1 ms, so millis() keeps being checked
+    while ((long)(wakeTime - millis()) > 0)
+    {
+        cli();
+        if (buttonEvent)
+        {
+            sei();
+            break;
+        }
+        sleep_enable();
+        sei(); // Instruction after sei is always executed, no wakeup can be lost before sleep
+        sleep_cpu();
+        sleep_disable();
+    }
+}
+
+void idleFor(unsigned long ms)
+{
+    // Timer0 overflow wakes us up every ~1 ms
+    unsigned long start = millis();
+    while (millis() - start < ms)
+    {
+        sleep_enable();
+        sleep_cpu();
+        sleep_disable();
+    }
+}
+
+bool displayWake(unsigned long currentTime)
+{
+    // Judged on the idle time as well as the state, so the answer does not depend on when displayIdleUpdate last ran
+    bool blanked = displayPower != DisplayAwake || (DISPLAY_DIM_TIMEOUT && currentTime - lastActivity >= DISPLAY_DIM_TIMEOUT);
+    lastActivity = currentTime;
+
+    if (!blanked)
+        return false;
+
+    if (displayPower == DisplayOff)
+    {
+        display.ssd1306_command(SSD1306_DISPLAYON);
+    }
+    display.dim(false);
+    displayPower = DisplayAwake;
+    return true;
+}
+
+void displayIdleUpdate(unsigned long currentTime)
+{
+    unsigned long idleTime = currentTime - lastActivity;
+
+    if (displayPower == DisplayAwake && DISPLAY_DIM_TIMEOUT && idleTime >= DISPLAY_DIM_TIMEOUT)
+    {
+        display.dim(true);
+        displayPower = DisplayDimmed;
+    }
+    if (displayPower != DisplayOff && DISPLAY_OFF_TIMEOUT && idleTime >= DISPLAY_OFF_TIMEOUT)
+    {
+        display.ssd1306_command(SSD1306_DISPLAYOFF);
+        displayPower = DisplayOff;
+    }
+}
\ No newline at end of file
@@ -20,10 +20,17 @@ void prepareScreen()
     display.setTextSize(1);
     display.setCursor(0, 3);
 
+    Zone &zone = zones[activeZone];
+    if (ZONE_COUNT > 1)
+    {
+        display.print(activeZone + 1);
+        display.print(' ');
+    }
+
     char targetTemp[7];
-    formatTemperature(TargetTemp, true, targetTemp, sizeof(targetTemp));
+    formatTemperature(zone.targetTemp, true, targetTemp, sizeof(targetTemp));
     char targetHum[6];
-    formatHumidity(TargetHumidity, targetHum, sizeof(targetHum));
+    formatHumidity(zone.targetHumidity, targetHum, sizeof(targetHum));
     display.print(targetTemp);
     display.print(' ');
     display.print(targetHum);
@@ -39,7 +46,7 @@ void formatTemperature(float Temperature, bool round, char *str, size_t str_len)
     memset(str, ' ', str_len);
 
     float temp = 0.0;
-    temp = min(Temperature + TemperatureCalibration, 70.); // Apply temperature calibration and limit to 70
+    temp = min(Temperature, 70.); // Limit to 70, readings are already calibrated
     if (Unit == TemperatureUnit::Fahrenheit)
     {
         temp = temp * 9.0 / 5.0 + 32.0; // Convert Celsius to Fahrenheit
@@ -50,7 +57,7 @@ void formatTemperature(float Temperature, bool round, char *str, size_t str_len)
     }
 
     // Move the first digit to the right if temperature is less than 100
-    int offset = (offset < 100) ? 4 : 5;
+    int offset = (temp < 100) ? 4 : 5;
     dtostrf(temp, 2, 1, str);
     str[offset] = Unit;
     str[offset + 1] = '\0';
@@ -71,7 +78,7 @@ void formatHumidity(float Humidity, char *str, size_t str_len)
 void drawheaterOn()
 {
     display.fillCircle(114, 6, 5, SSD1306_WHITE);
-    if (!heaterOn)
+    if (!zones[activeZone].heaterOn)
     {
         display.fillCircle(114, 6, 4, SSD1306_BLACK);
     }
@@ -0,0 +1,71 @@
+#include "sram.h"
+
+extern uint8_t _end;          // End of .bss, start of the heap
+extern uint8_t __stack;       // Top of the stack (RAMEND)
+extern char *__brkval;        // Heap break, 0 until the first malloc
+
+MemoryStats memoryStats;
+bool memoryAlarm = false;
+
+// Runs from .init3, before .data and .bss are set up and before any constructor, so nothing in the
+// painted area is in use yet. Naked and without locals so it does not touch the stack itself.
+void paintStack() __attribute__((naked, used, section(".init3")));
+void paintStack()
+{
+    uint8_t *p = &_end;
+    while (p <= &__stack)
+    {
+        *p = STACK_CANARY;
+        p++;
+    }
+}
+
+void memoryCheck()
+{
+    uint8_t *heapEnd = __brkval ? (uint8_t *)__brkval : &_end;
+    uint8_t *stackPointer = (uint8_t *)SP;
+
+    // The stack grows down towards the heap, the first overwritten canary is its deepest point so far
+    uint8_t *p = heapEnd;
+    while (p < stackPointer && *p == STACK_CANARY)
+        p++;
+
+    memoryStats.freeNow = stackPointer - heapEnd;
+    memoryStats.freeMinimum = p - heapEnd;
+    memoryStats.heapUsed = heapEnd - &_end;
+    memoryStats.stackPeak = &__stack - p;
+
+    if (memoryStats.freeMinimum < MEMORY_ALARM_THRESHOLD)
+        memoryAlarm = true;
+}
+
+bool maybeCheckMemory(unsigned long currentTime)
+{
+    static unsigned long lastMemoryCheck = 0;
+    static unsigned long lastMemoryReport = 0;
+
+    if (currentTime - lastMemoryCheck < MEMORY_CHECK_INTERVAL)
+        return false;
+    lastMemoryCheck = currentTime;
+
+    bool alarmBefore = memoryAlarm;
+    memoryCheck();
+
+    if (currentTime - lastMemoryReport >= MEMORY_REPORT_INTERVAL || memoryAlarm != alarmBefore)
+    {
+        // $MEM,<free now>,<free minimum>,<heap used>,<stack peak>,<alarm>
+        Serial.print(F("$MEM,"));
+        Serial.print(memoryStats.freeNow);
+        Serial.print(',');
+        Serial.print(memoryStats.freeMinimum);
+        Serial.print(',');
+        Serial.print(memoryStats.heapUsed);
+        Serial.print(',');
+        Serial.print(memoryStats.stackPeak);
+        Serial.print(',');
+        Serial.println(memoryAlarm);
+        lastMemoryReport = currentTime;
+    }
+
+    return memoryAlarm && !alarmBefore;
+}
\ No newline at end of file
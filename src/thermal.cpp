@@ -0,0 +1,106 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#include "drybox.h"
+#include "thermal.h"
+
+// Progress through the current heater phase, only kept in RAM
+struct ThermalLearner
+{
+    bool primed = false;      // Got the first sample
+    bool heating = false;     // Heater state of the current phase
+    bool settled = false;     // Trough (heating) or peak (cooling) after the switch has been found
+    float switchTemp = 0;     // Temperature the switch was decided on
+    float lastTemp = 0;
+    float extremeTemp = 0;    // Lowest (heating) or highest (cooling) temperature so far
+};
+
+static ThermalLearner learners[ZONE_COUNT];
+static bool thermalDirty = false;
+
+// Exponential average, the first measurement of each value is taken as is. The values are measured at different
+// points of a cycle, so each one tracks its own first measurement.
+static void learn(ThermalModel &model, ThermalParameter parameter, float &value, float sample)
+{
+    value = (model.seeded & parameter) ? value + (sample - value) / 4 : sample;
+    model.seeded |= parameter;
+}
+
+void thermalLearn(uint8_t zone, float temperature, bool heaterRunning)
+{
+    ThermalLearner &learner = learners[zone];
+    ThermalModel &model = zones[zone].thermal;
+
+    if (!learner.primed || heaterRunning != learner.heating)
+    {
+        // A phase that got past its trough or peak has taught the model something
+        if (learner.primed && learner.settled)
+        {
+            if (learner.heating && model.cycles < 255)
+                model.cycles++; // A full cycle ends with the heater being switched off
+            thermalDirty = true;
+
+            Serial.print(F("$THM,"));
+            Serial.print(zone);
+            Serial.print(',');
+            Serial.print(model.overshoot);
+            Serial.print(',');
+            Serial.println(model.undershoot);
+        }
+
+        learner.switchTemp = learner.primed ? learner.lastTemp : temperature;
+        learner.primed = true;
+        learner.heating = heaterRunning;
+        learner.settled = false;
+        learner.extremeTemp = temperature;
+        learner.lastTemp = temperature;
+        return;
+    }
+
+    learner.lastTemp = temperature;
+    if (learner.settled)
+        return;
+
+    // After switching on the temperature keeps falling for a while, after switching off it keeps rising
+    float beyond = learner.heating ? learner.extremeTemp - temperature : temperature - learner.extremeTemp;
+    if (beyond > 0)
+    {
+        learner.extremeTemp = temperature;
+    }
+    else if (-beyond >= THERMAL_SETTLE_MARGIN)
+    {
+        float lag = learner.heating ? learner.switchTemp - learner.extremeTemp : learner.extremeTemp - learner.switchTemp;
+        lag = constrain(lag, 0, THERMAL_MAX_LEAD);
+        if (learner.heating)
+            learn(model, ThermalUndershoot, model.undershoot, lag);
+        else
+            learn(model, ThermalOvershoot, model.overshoot, lag);
+        learner.settled = true;
+    }
+}
+
+void thermalLoad()
+{
+    for (uint8_t i = 0; i < ZONE_COUNT; i++)
+    {
+        ThermalModel model;
+        EEPROM.get(thermalEepromAddress(i), model);
+        if (model.magic == THERMAL_MODEL_MAGIC)
+            zones[i].thermal = model; // Unprogrammed or foreign EEPROM content starts from scratch
+        learners[i] = ThermalLearner();
+    }
+}
+
+void maybeSaveThermal(unsigned long currentTime)
+{
+    static unsigned long lastThermalSave = 0;
+
+    if (!thermalDirty || currentTime - lastThermalSave < THERMAL_SAVE_INTERVAL)
+        return;
+
+    for (uint8_t i = 0; i < ZONE_COUNT; i++)
+        EEPROM.put(thermalEepromAddress(i), zones[i].thermal);
+
+    thermalDirty = false;
+    lastThermalSave = currentTime;
+}
\ No newline at end of file
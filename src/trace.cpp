@@ -0,0 +1,375 @@
+#if defined(DRYBOX_TRACE) || defined(DRYBOX_REPLAY)
+
+#include "drybox.h"
+#include "trace.h"
+
+#ifdef DRYBOX_REPLAY
+#include <native.h>
+
+static void replayOutput(uint8_t kind, uint8_t index, uint8_t value);
+#else
+static unsigned long lastRecordTime = 0;
+
+static void printHex(uint8_t value)
+{
+    static const char digits[] PROGMEM = "0123456789ABCDEF";
+    Serial.write(pgm_read_byte(&digits[value >> 4]));
+    Serial.write(pgm_read_byte(&digits[value & 0x0F]));
+}
+
+static void emit(uint8_t kind, uint8_t index, uint16_t delta, const uint8_t *payload, uint8_t length)
+{
+    Serial.print(F(TRACE_PREFIX));
+    printHex(kind << 4 | index);
+    printHex(delta & 0xFF);
+    printHex(delta >> 8);
+    for (uint8_t i = 0; i < length; i++)
+        printHex(payload[i]);
+    Serial.println();
+}
+
+static void record(uint8_t kind, uint8_t index, unsigned long time, const void *payload, uint8_t length)
+{
+    unsigned long delta = time - lastRecordTime;
+    while (delta > 0xFFFF)
+    {
+        emit(TraceGap, 0, 0xFFFF, nullptr, 0);
+        delta -= 0xFFFF;
+    }
+    emit(kind, index, delta, (const uint8_t *)payload, length);
+    lastRecordTime = time;
+}
+#endif
+
+#ifdef DRYBOX_REPLAY
+// The replay hands the inputs to the controller itself and only checks the outputs against the recording
+void traceStart(unsigned long)
+{
+}
+
+void traceSample(uint8_t, bool, unsigned long)
+{
+}
+
+void traceButtons(bool, bool, bool, unsigned long)
+{
+}
+
+void traceHeater(uint8_t zone, bool on, unsigned long)
+{
+    replayOutput(TraceHeater, zone, on);
+}
+
+void traceMenu(uint8_t state, unsigned long)
+{
+    replayOutput(TraceMenu, 0, state);
+}
+#else
+void traceStart(unsigned long time)
+{
+    for (uint8_t i = 0; i < ZONE_COUNT; i++)
+    {
+        const Zone &zone = zones[i];
+        TraceStartPayload start;
+        start.targetTemp = zone.targetTemp;
+        start.temperatureGain = zone.temperatureCalibration.gain;
+        start.temperatureOffset = zone.temperatureCalibration.offset;
+        start.humidityGain = zone.humidityCalibration.gain;
+        start.humidityOffset = zone.humidityCalibration.offset;
+        start.overshoot = zone.thermal.overshoot;
+        start.undershoot = zone.thermal.undershoot;
+        start.targetHumidity = zone.targetHumidity;
+        start.flags = (zone.heaterOn ? 1 : 0) | (Unit == TemperatureUnit::Fahrenheit ? 2 : 0);
+        start.cycles = zone.thermal.cycles;
+        start.seeded = zone.thermal.seeded;
+        record(TraceStart, i, time, &start, sizeof(start));
+    }
+}
+
+void traceSample(uint8_t zone, bool sampled, unsigned long time)
+{
+    if (!sampled)
+    {
+        record(TraceSampleFailed, zone, time, nullptr, 0);
+        return;
+    }
+
+    struct __attribute__((packed))
+    {
+        int16_t temperature;
+        int16_t humidity;
+    } sample = {zones[zone].rawTemperature, zones[zone].rawHumidity};
+    record(TraceSample, zone, time, &sample, sizeof(sample));
+}
+
+void traceButtons(bool onOff, bool up, bool down, unsigned long time)
+{
+    static bool previous[3] = {false, false, false};
+    bool current[3] = {onOff, up, down};
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (current[i] == previous[i])
+            continue;
+        uint8_t state = (current[i] ? 1 : 0) | activeZone << 1;
+        record(TraceButton, i, time, &state, 1);
+        previous[i] = current[i];
+    }
+}
+
+void traceHeater(uint8_t zone, bool on, unsigned long time)
+{
+    uint8_t value = on;
+    record(TraceHeater, zone, time, &value, 1);
+}
+
+void traceMenu(uint8_t state, unsigned long time)
+{
+    record(TraceMenu, 0, time, &state, 1);
+}
+#endif
+
+#ifdef DRYBOX_REPLAY
+
+// Hands the recorded readings to the zones in place of the DHT20
+class ReplayZoneSensor : public ZoneSensor
+{
+public:
+    bool pending = false;  // Trace holds a reading for the current pass
+    bool answered = false;
+    float temperature = 0;
+    float humidity = 0;
+
+    bool begin() override
+    {
+        return true;
+    }
+
+    bool read(float &temperature, float &humidity) override;
+};
+
+struct ExpectedOutput
+{
+    uint8_t kind;
+    uint8_t index;
+    uint8_t value;
+};
+
+static ReplayZoneSensor replaySensors[ZONE_COUNT];
+static ExpectedOutput expected[8];
+static uint8_t expectedCount = 0;
+static unsigned long replayTime = 0;
+static bool replayButtons[3] = {false, false, false};
+static unsigned long replayRecords = 0;
+static unsigned long replayPasses = 0;
+static unsigned long replayDivergences = 0;
+
+static void divergence(const __FlashStringHelper *what, uint8_t kind, uint8_t index, uint8_t value)
+{
+    // $DIV,<virtual time>,<what>,<kind>,<index>,<value>
+    Serial.print(F("$DIV,"));
+    Serial.print(replayTime);
+    Serial.print(',');
+    Serial.print(what);
+    Serial.print(',');
+    Serial.print(kind);
+    Serial.print(',');
+    Serial.print(index);
+    Serial.print(',');
+    Serial.println(value);
+    replayDivergences++;
+}
+
+bool ReplayZoneSensor::read(float &temperature, float &humidity)
+{
+    if (!pending)
+    {
+        divergence(F("unrecorded sample"), TraceSample, this - replaySensors, 0);
+        return false;
+    }
+    pending = false;
+    temperature = this->temperature;
+    humidity = this->humidity;
+    return answered;
+}
+
+static void replayOutput(uint8_t kind, uint8_t index, uint8_t value)
+{
+    for (uint8_t i = 0; i < expectedCount; i++)
+    {
+        if (expected[i].kind == kind && expected[i].index == index && expected[i].value == value)
+        {
+            expected[i] = expected[--expectedCount];
+            return;
+        }
+    }
+    divergence(F("unexpected"), kind, index, value);
+}
+
+// Runs the pass the batch of records with the same time stamp was recorded in and checks its outputs
+static void replayPass(bool &setupDone, void (*afterPass)(unsigned long time))
+{
+    nativeTime = replayTime; // What millis() returns inside the pass
+    if (!setupDone)
+    {
+        sampleAllZones(replayTime);
+        setupDone = true;
+    }
+    else
+    {
+        loopPass(replayTime, replayButtons[0], replayButtons[1], replayButtons[2]);
+    }
+    replayPasses++;
+
+    for (uint8_t i = 0; i < expectedCount; i++)
+        divergence(F("missing"), expected[i].kind, expected[i].index, expected[i].value);
+    expectedCount = 0;
+
+    for (uint8_t i = 0; i < ZONE_COUNT; i++)
+    {
+        if (replaySensors[i].pending)
+            divergence(F("sample not taken"), TraceSample, i, 0);
+        replaySensors[i].pending = false;
+    }
+
+    if (afterPass)
+        afterPass(replayTime);
+}
+
+static uint8_t hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return 0xFF;
+}
+
+static void applyStart(uint8_t zoneIndex, const TraceStartPayload &start)
+{
+    Zone &zone = zones[zoneIndex];
+    zone.targetTemp = start.targetTemp;
+    zone.temperatureCalibration.gain = start.temperatureGain;
+    zone.temperatureCalibration.offset = start.temperatureOffset;
+    zone.humidityCalibration.gain = start.humidityGain;
+    zone.humidityCalibration.offset = start.humidityOffset;
+    zone.thermal.overshoot = start.overshoot;
+    zone.thermal.undershoot = start.undershoot;
+    zone.thermal.cycles = start.cycles;
+    zone.thermal.seeded = start.seeded;
+    zone.targetHumidity = start.targetHumidity;
+    zone.heaterOn = start.flags & 1;
+    Unit = (start.flags & 2) ? TemperatureUnit::Fahrenheit : TemperatureUnit::Celsius;
+}
+
+ReplayResult replayRun(FILE *file, void (*afterPass)(unsigned long time))
+{
+    for (uint8_t i = 0; i < ZONE_COUNT; i++)
+    {
+        replaySensors[i] = ReplayZoneSensor();
+        zones[i].sensor = &replaySensors[i];
+    }
+    expectedCount = 0;
+    replayTime = 0;
+    replayRecords = 0;
+    replayPasses = 0;
+    replayDivergences = 0;
+
+    bool setupDone = false;
+    bool batchPending = false;
+    char line[sizeof(TRACE_PREFIX) + 2 * TRACE_RECORD_MAX + 2];
+    uint8_t data[TRACE_RECORD_MAX];
+
+    while (fgets(line, sizeof(line), file))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (strcmp(line, "$END") == 0)
+            break;
+        if (strncmp(line, TRACE_PREFIX, strlen(TRACE_PREFIX)) != 0)
+            continue;
+
+        uint8_t length = 0;
+        for (const char *p = line + strlen(TRACE_PREFIX); p[0] && p[1] && length < TRACE_RECORD_MAX; p += 2)
+            data[length++] = hexValue(p[0]) << 4 | hexValue(p[1]);
+        if (length < 3)
+            continue;
+
+        uint8_t kind = data[0] >> 4;
+        uint8_t index = data[0] & 0x0F;
+        uint16_t delta = data[1] | data[2] << 8;
+        const uint8_t *payload = data + 3;
+        replayRecords++;
+
+        // A new time stamp closes the pass the previous records belong to
+        if (delta > 0 && batchPending)
+        {
+            replayPass(setupDone, afterPass);
+            batchPending = false;
+        }
+        replayTime += delta;
+
+        if (index >= ZONE_COUNT && kind != TraceButton && kind != TraceMenu && kind != TraceGap)
+            continue;
+
+        switch (kind)
+        {
+        case TraceStart:
+            if (length >= 3 + sizeof(TraceStartPayload))
+            {
+                TraceStartPayload start;
+                memcpy(&start, payload, sizeof(start));
+                applyStart(index, start);
+            }
+            break;
+        case TraceSample:
+        case TraceSampleFailed:
+        {
+            ReplayZoneSensor &sensor = replaySensors[index];
+            sensor.pending = true;
+            sensor.answered = kind == TraceSample && length >= 7;
+            if (sensor.answered)
+            {
+                sensor.temperature = (int16_t)(payload[0] | payload[1] << 8) / 100.0;
+                sensor.humidity = (int16_t)(payload[2] | payload[3] << 8) / 100.0;
+            }
+            batchPending = true;
+            break;
+        }
+        case TraceButton:
+            if (index < 3 && length >= 4)
+            {
+                replayButtons[index] = payload[0] & 1;
+                activeZone = min(payload[0] >> 1, ZONE_COUNT - 1);
+            }
+            batchPending = true;
+            break;
+        case TraceHeater:
+        case TraceMenu:
+            if (length >= 4 && expectedCount < sizeof(expected) / sizeof(expected[0]))
+                expected[expectedCount++] = {kind, index, payload[0]};
+            batchPending = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (batchPending)
+        replayPass(setupDone, afterPass);
+
+    // $REPLAY,<records>,<passes>,<divergences>
+    Serial.print(F("$REPLAY,"));
+    Serial.print(replayRecords);
+    Serial.print(',');
+    Serial.print(replayPasses);
+    Serial.print(',');
+    Serial.println(replayDivergences);
+
+    return {replayRecords, replayPasses, replayDivergences};
+}
+
+#endif // DRYBOX_REPLAY
+
+#endif // DRYBOX_TRACE || DRYBOX_REPLAY
\ No newline at end of file
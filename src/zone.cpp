@@ -0,0 +1,113 @@
+#include <math.h>
+
+#include "zone.h"
+
+bool zoneSample(Zone &zone)
+{
+    float temperature, humidity;
+    if (!zone.sensor->read(temperature, humidity))
+        return false;
+
+    // Kept at 0.01 resolution, far below the sensor accuracy, so a recorded trace replays exactly
+    zone.rawTemperature = lround(temperature * 100);
+    zone.rawHumidity = lround(humidity * 100);
+    zoneApplyCalibration(zone);
+    return true;
+}
+
+void zoneApplyCalibration(Zone &zone)
+{
+    zone.temperature = calibrationApply(zone.temperatureCalibration, zone.rawTemperature) / 100.0;
+    zone.humidity = calibrationApply(zone.humidityCalibration, zone.rawHumidity) / 100.0;
+}
+
+void zoneSwitchPoints(const Zone &zone, float &switchOnAt, float &switchOffAt)
+{
+    // Once the box's thermal lag is known, switch early so the overshoot and undershoot end at the band edges
+    switchOffAt = zone.targetTemp + HEATER_HYSTERESIS;
+    switchOnAt = zone.targetTemp - HEATER_HYSTERESIS;
+    const ThermalModel &model = zone.thermal;
+    if (model.cycles >= THERMAL_MIN_CYCLES)
+    {
+        switchOffAt -= model.overshoot;
+        switchOnAt += model.undershoot;
+        if (switchOffAt - switchOnAt < THERMAL_MIN_SWITCH_GAP)
+        {
+            float middle = (switchOffAt + switchOnAt) / 2;
+            switchOffAt = middle + THERMAL_MIN_SWITCH_GAP / 2;
+            switchOnAt = middle - THERMAL_MIN_SWITCH_GAP / 2;
+        }
+    }
+}
+
+bool zoneHeaterDemand(const Zone &zone)
+{
+    if (!zone.heaterOn || zone.humidity <= zone.targetHumidity)
+        return false; // Heater disabled or box already dry enough
+
+    float switchOnAt, switchOffAt;
+    zoneSwitchPoints(zone, switchOnAt, switchOffAt);
+
+    if (zone.temperature < switchOnAt)
+        return true;
+    if (zone.temperature > switchOffAt)
+        return false;
+    return zone.heaterRunning; // Inside the band, keep the current state
+}
+
+uint8_t zoneNextDue(const Zone zones[], uint8_t count, unsigned long lastRead, unsigned long currentTime)
+{
+    if (currentTime - lastRead < SENSOR_MIN_INTERVAL / count)
+        return count;
+
+    uint8_t nextZone = count;
+    unsigned long mostOverdue = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        unsigned long sinceSample = currentTime - zones[i].lastSampleTime;
+        if (sinceSample >= zones[i].sampleInterval && (nextZone == count || sinceSample - zones[i].sampleInterval > mostOverdue))
+        {
+            nextZone = i;
+            mostOverdue = sinceSample - zones[i].sampleInterval;
+        }
+    }
+    return nextZone;
+}
+
+static float limitStep(float step)
+{
+    return step < SENSOR_MIN_STEP ? SENSOR_MIN_STEP : (step > SENSOR_MAX_STEP ? SENSOR_MAX_STEP : step);
+}
+
+void zoneAdaptInterval(Zone &zone, float lastTemperature, float lastHumidity, unsigned long elapsed)
+{
+    float seconds = (elapsed > 0 ? elapsed : 1) / 1000.0;
+    float temperatureRate = fabs(zone.temperature - lastTemperature) / seconds; // C per second
+    float humidityRate = fabs(zone.humidity - lastHumidity) / seconds;          // % per second
+
+    // The closer a reading is to where the heater switches, the smaller the change it may make between two samples
+    float temperatureStep = SENSOR_MAX_STEP;
+    float humidityStep = SENSOR_MAX_STEP;
+    if (zone.heaterOn)
+    {
+        float switchOnAt, switchOffAt;
+        zoneSwitchPoints(zone, switchOnAt, switchOffAt);
+        temperatureStep = limitStep(fmin(fabs(zone.temperature - switchOnAt), fabs(zone.temperature - switchOffAt)) / 2);
+        humidityStep = limitStep(fabs(zone.humidity - zone.targetHumidity) / 2);
+    }
+
+    float interval = SENSOR_MAX_INTERVAL / 1000.0;
+    if (temperatureRate > 0)
+        interval = fmin(interval, temperatureStep / temperatureRate);
+    if (humidityRate > 0)
+        interval = fmin(interval, humidityStep / humidityRate);
+
+    // Shortened at once, lengthened by at most half per sample so one quiet reading does not stretch it
+    unsigned long next = interval * 1000;
+    unsigned long grown = (unsigned long)zone.sampleInterval * 3 / 2;
+    if (next < SENSOR_MIN_INTERVAL)
+        next = SENSOR_MIN_INTERVAL;
+    if (next > SENSOR_MAX_INTERVAL)
+        next = SENSOR_MAX_INTERVAL;
+    zone.sampleInterval = next < grown ? next : grown;
+}
\ No newline at end of file
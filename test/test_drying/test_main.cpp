@@ -0,0 +1,102 @@
+#include <Adafruit_SSD1306.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#include "drybox.h"
+#include "drying.h"
+#include "menu.h"
+#include "screen.h"
+
+#define SAMPLE_INTERVAL 5000UL
+#define TARGET 40
+
+static unsigned long time = 0;
+
+void setUp()
+{
+    time += 2 * DRYING_MAX_GAP * DRYING_POINT_INTERVAL; // Long enough without readings to start a fresh fit
+    srand(1);
+}
+
+void tearDown()
+{
+}
+
+// Simulated drying: the humidity moves at a rate in % per hour, read every 5 s with +-0.1 % sensor noise
+static float dry(unsigned long minutes, float humidity, float ratePerHour)
+{
+    for (unsigned long elapsed = 0; elapsed < minutes * 60000; elapsed += SAMPLE_INTERVAL)
+    {
+        time += SAMPLE_INTERVAL;
+        humidity += ratePerHour * SAMPLE_INTERVAL / 3600000.0;
+        dryingSample(0, humidity + (rand() % 21 - 10) / 100.0, time);
+    }
+    return humidity;
+}
+
+static DryingState estimate(uint16_t &minutes)
+{
+    minutes = 0;
+    return dryingEstimate(0, TARGET, minutes);
+}
+
+void test_eta_follows_a_steady_fall()
+{
+    uint16_t minutes;
+    float humidity = dry(DRYING_MIN_POINTS - 2, 60.0, -6.0);
+    TEST_ASSERT_EQUAL(DryingUnknown, estimate(minutes));
+
+    humidity = dry(30, humidity, -6.0);
+    TEST_ASSERT_EQUAL(DryingProgress, estimate(minutes));
+    float actual = (humidity - TARGET) / 6.0 * 60;
+    TEST_ASSERT_FLOAT_WITHIN(actual * 0.15, actual, minutes);
+}
+
+void test_flat_humidity_above_target_is_a_stall()
+{
+    uint16_t minutes;
+    float humidity = dry(60, 60.0, -6.0);
+    dry(75, humidity, 0); // The fit needs time to forget the fall
+    TEST_ASSERT_EQUAL(DryingStalled, estimate(minutes));
+}
+
+void test_rising_humidity_is_not_a_stall()
+{
+    uint16_t minutes;
+    dry(40, 45.0, 3.0); // Lid left open
+    TEST_ASSERT_EQUAL(DryingUnknown, estimate(minutes));
+}
+
+void test_done_at_target()
+{
+    uint16_t minutes;
+    dry(40, TARGET - 2, -0.5);
+    TEST_ASSERT_EQUAL(DryingDone, estimate(minutes));
+}
+
+void test_stall_is_only_shown_while_heating()
+{
+    float humidity = dry(60, 60.0, -6.0);
+    dry(75, humidity, 0); // The fit needs time to forget the fall
+    activeZone = 0;
+    zones[0].targetHumidity = TARGET;
+
+    zones[0].heaterOn = true;
+    mainScreenMenu.render();
+    TEST_ASSERT_TRUE(display.frame.find("STALL") != std::string::npos);
+
+    zones[0].heaterOn = false; // Not drying, so not drying is no news
+    mainScreenMenu.render();
+    TEST_ASSERT_TRUE(display.frame.find("STALL") == std::string::npos);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_eta_follows_a_steady_fall);
+    RUN_TEST(test_flat_humidity_above_target_is_a_stall);
+    RUN_TEST(test_rising_humidity_is_not_a_stall);
+    RUN_TEST(test_done_at_target);
+    RUN_TEST(test_stall_is_only_shown_while_heating);
+    return UNITY_END();
+}
@@ -0,0 +1,143 @@
+#include <native.h>
+#include <unity.h>
+
+#include "drybox.h"
+#include "heater.h"
+#include "interlock.h"
+
+#define WINDOW_TICKS (4000 / INTERLOCK_TICK_MS)
+#define RAMP_TICKS (HEATER_SOFT_START_MS / INTERLOCK_TICK_MS + 5) // The fixed point step rounds down
+
+void setUp()
+{
+    zones[0] = Zone();
+    heaterDriverInit();
+}
+
+void tearDown()
+{
+}
+
+static void usePin(uint8_t pin)
+{
+    zones[0].heaterPin = pin;
+    heaterForceOff(0);
+}
+
+static void ticks(unsigned long count)
+{
+    while (count--)
+        heaterDriverTick();
+}
+
+// Ticks the pin is high over the next windows
+static unsigned long highTicks(uint8_t pin, unsigned long windows)
+{
+    unsigned long high = 0;
+    for (unsigned long i = 0; i < windows * WINDOW_TICKS; i++)
+    {
+        heaterDriverTick();
+        high += nativePinLevel[pin] == HIGH;
+    }
+    return high;
+}
+
+#if HEATER_DRIVE_MODE == HEATER_DRIVE_PWM
+void test_timer1_pin_ramps_up_softly()
+{
+    usePin(9);
+    heaterDrive(0, 255);
+
+    ticks(HEATER_SOFT_START_MS / INTERLOCK_TICK_MS / 2);
+    TEST_ASSERT_UINT8_WITHIN(3, 128, heaterDuty(0));
+    TEST_ASSERT_TRUE(TCCR1A & _BV(COM1A1));
+    TEST_ASSERT_UINT16_WITHIN(ICR1 / 50, ICR1 / 2, OCR1A);
+
+    ticks(RAMP_TICKS);
+    TEST_ASSERT_EQUAL_UINT8(255, heaterDuty(0));
+    TEST_ASSERT_EQUAL_UINT16(ICR1, OCR1A);
+
+    // Switched off the compare value is cleared, so the output is low when the pin is connected again
+    heaterDrive(0, 0);
+    ticks(1);
+    TEST_ASSERT_EQUAL_UINT8(0, heaterDuty(0));
+    TEST_ASSERT_FALSE(TCCR1A & _BV(COM1A1));
+    TEST_ASSERT_EQUAL_UINT16(0, OCR1A);
+    TEST_ASSERT_EQUAL_UINT8(LOW, nativePinLevel[9]);
+}
+#else
+// Timer1 compare values only load at the start of a 4 s window, so a Timer1 pin connected again after a full duty
+// run would be high for the rest of the window. The pin is time-proportioned instead and never connected to Timer1,
+// so its level is what the soft start asks for.
+void test_timer1_pin_restarts_with_the_ramp()
+{
+    usePin(9);
+    heaterDrive(0, 255);
+    ticks(RAMP_TICKS);
+    TEST_ASSERT_EQUAL_UINT32(WINDOW_TICKS, highTicks(9, 1));
+
+    heaterDrive(0, 0);
+    ticks(WINDOW_TICKS / 3);
+    TEST_ASSERT_EQUAL_UINT8(LOW, nativePinLevel[9]);
+
+    // The first second of the ramp reaches a fifth of full duty
+    heaterDrive(0, 255);
+    unsigned long high = 0;
+    for (unsigned long i = 0; i < 1000 / INTERLOCK_TICK_MS; i++)
+    {
+        heaterDriverTick();
+        high += nativePinLevel[9] == HIGH;
+        TEST_ASSERT_FALSE(TCCR1A & (_BV(COM1A1) | _BV(COM1B1)));
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(WINDOW_TICKS * 1000 / HEATER_SOFT_START_MS, high);
+    TEST_ASSERT_LESS_OR_EQUAL(255 * 1000 / HEATER_SOFT_START_MS, heaterDuty(0));
+}
+#endif
+
+void test_other_pin_is_time_proportioned()
+{
+    usePin(4);
+    heaterDrive(0, 64);
+    ticks(RAMP_TICKS);
+
+    TEST_ASSERT_EQUAL_UINT8(64, heaterDuty(0));
+    TEST_ASSERT_UINT32_WITHIN(2 * 3, 3 * WINDOW_TICKS * 64 / 255, highTicks(4, 3));
+
+    heaterDrive(0, 255);
+    ticks(RAMP_TICKS);
+    TEST_ASSERT_EQUAL_UINT32(2 * WINDOW_TICKS, highTicks(4, 2));
+}
+
+void test_other_pin_ramps_up_softly()
+{
+    // The first window after switching on only sees the start of the ramp
+    usePin(4);
+    heaterDrive(0, 255);
+    TEST_ASSERT_LESS_THAN(WINDOW_TICKS, highTicks(4, 1));
+}
+
+void test_force_off_drops_other_pin_at_once()
+{
+    usePin(4);
+    heaterDrive(0, 255);
+    ticks(RAMP_TICKS);
+    TEST_ASSERT_EQUAL_UINT8(HIGH, nativePinLevel[4]);
+
+    heaterForceOff(0);
+    TEST_ASSERT_EQUAL_UINT8(LOW, nativePinLevel[4]);
+    TEST_ASSERT_EQUAL_UINT32(0, highTicks(4, 1));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+#if HEATER_DRIVE_MODE == HEATER_DRIVE_PWM
+    RUN_TEST(test_timer1_pin_ramps_up_softly);
+#else
+    RUN_TEST(test_timer1_pin_restarts_with_the_ramp);
+#endif
+    RUN_TEST(test_other_pin_is_time_proportioned);
+    RUN_TEST(test_other_pin_ramps_up_softly);
+    RUN_TEST(test_force_off_drops_other_pin_at_once);
+    return UNITY_END();
+}
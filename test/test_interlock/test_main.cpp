@@ -0,0 +1,266 @@
+#include <EEPROM.h>
+#include <native.h>
+#include <unity.h>
+
+#include "dht20.h"
+#include "drybox.h"
+#include "heater.h"
+#include "interlock.h"
+#include "screen.h"
+
+extern "C" void TIMER2_COMPA_vect(void);
+void setup();
+
+static NativeDht20 sensor;
+
+void setUp()
+{
+    zones[0] = Zone();
+    zones[0].heaterOn = true;
+    zones[0].targetTemp = 45; // Switches on at 43.5, the rise is watched below 40.5
+    zones[0].targetHumidity = 30;
+    interlockClear(0);
+
+    sensor = NativeDht20();
+    sensor.temperature = 30.0;
+    sensor.humidity = 60.0;
+    nativeI2cAttach(NATIVE_DHT20_ADDRESS, &sensor);
+}
+
+void tearDown()
+{
+}
+
+// One sample a minute at the given temperature with the heater in the given state
+static void samples(unsigned long &time, unsigned long minutes, float from, float to, bool heaterRunning)
+{
+    for (unsigned long i = 1; i <= minutes; i++)
+    {
+        time += 60000;
+        float temperature = from + (to - from) * i / minutes;
+        interlockSample(0, temperature, temperature, heaterRunning, time);
+    }
+}
+
+void test_first_sample_only_sets_the_reference()
+{
+    // Warm box at boot and again after a fault was cleared, neither is a rise while off
+    interlockSample(0, 30.0, 30.0, false, 1000);
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+
+    interlockClear(0);
+    interlockSample(0, 31.0, 31.0, false, 2000);
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+}
+
+void test_heating_from_cold_keeps_the_watch_happy()
+{
+    unsigned long time = 0;
+    samples(time, 1, 20.0, 20.0, true);
+    samples(time, 120, 20.0, 41.0, true); // Slow box, a bit over 1 C per 10 minutes
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+}
+
+void test_dead_heater_far_below_target_faults()
+{
+    unsigned long time = 0;
+    samples(time, 1, 25.0, 25.0, true);
+    samples(time, RUNAWAY_HEATING_WINDOW / 60000 - 1, 25.0, 25.5, true);
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+
+    samples(time, 2, 25.5, 25.5, true);
+    TEST_ASSERT_EQUAL_UINT8(FaultRunawayHeating, interlockFaults(0));
+}
+
+void test_heater_crawling_near_the_band_is_not_runaway()
+{
+    // A weak heater or a lid left ajar can hold the box just below the switch on point for hours
+    unsigned long time = 0;
+    samples(time, 1, 41.0, 41.0, true);
+    samples(time, 180, 41.0, 41.4, true);
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+}
+
+void test_drop_below_the_band_while_heating_faults()
+{
+    unsigned long time = 0;
+    samples(time, 1, 43.0, 43.0, true);
+    samples(time, 3, 43.0, 39.0, true); // Heater element failed open, the box cools while it is driven
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+
+    samples(time, RUNAWAY_DROP_WINDOW / 60000 + 1, 39.0, 38.0, true);
+    TEST_ASSERT_EQUAL_UINT8(FaultRunawayHeating, interlockFaults(0));
+}
+
+void test_drop_that_recovers_is_not_runaway()
+{
+    unsigned long time = 0;
+    samples(time, 1, 43.0, 43.0, true);
+    samples(time, 2, 43.0, 39.0, true); // Door opened
+    samples(time, 4, 39.0, 41.0, true);
+    samples(time, 30, 41.0, 43.4, true);
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+}
+
+void test_rise_while_off_faults()
+{
+    unsigned long time = 0;
+    samples(time, 1, 46.0, 46.0, false);
+    samples(time, 5, 46.0, 50.0, false);
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+
+    samples(time, 2, 50.0, 52.0, false); // Relay welded shut
+    TEST_ASSERT_EQUAL_UINT8(FaultRunawayCooling, interlockFaults(0));
+}
+
+// Moves the virtual clock like the board does: an interlock tick every 10 ms and a loop pass every 100 ms
+static void run(unsigned long ms, bool onOff = false)
+{
+    for (unsigned long elapsed = 0; elapsed < ms; elapsed += INTERLOCK_TICK_MS)
+    {
+        nativeTime += INTERLOCK_TICK_MS;
+        TIMER2_COMPA_vect();
+        if (nativeTime % 100 == 0)
+            loopPass(nativeTime, onOff, false, false);
+    }
+}
+
+// Short press of the on/off button on the main screen switches the heater on or off
+static void toggleHeaterSetting()
+{
+    run(200, true);
+    run(100);
+}
+
+void test_dht20_reading_is_decoded()
+{
+    Dht20ZoneSensor dht20Sensor;
+    dht20Sensor.attach(&dht20, NO_MUX_CHANNEL);
+    float temperature = 0, humidity = 0;
+
+    TEST_ASSERT_TRUE(dht20Sensor.read(temperature, humidity));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 30.0, temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 60.0, humidity);
+    TEST_ASSERT_EQUAL_UINT32(1, sensor.triggers);
+}
+
+void test_dht20_rejects_bad_frames()
+{
+    Dht20ZoneSensor dht20Sensor;
+    dht20Sensor.attach(&dht20, NO_MUX_CHANNEL);
+    float temperature = 0, humidity = 0;
+
+    sensor.busy = true;
+    TEST_ASSERT_FALSE(dht20Sensor.read(temperature, humidity));
+    sensor.busy = false;
+
+    sensor.calibrated = false;
+    TEST_ASSERT_FALSE(dht20Sensor.read(temperature, humidity));
+    sensor.calibrated = true;
+
+    sensor.corrupt = true;
+    TEST_ASSERT_FALSE(dht20Sensor.read(temperature, humidity));
+    sensor.corrupt = false;
+
+    nativeI2cAttach(NATIVE_DHT20_ADDRESS, nullptr); // Unplugged
+    TEST_ASSERT_FALSE(dht20Sensor.read(temperature, humidity));
+    nativeI2cAttach(NATIVE_DHT20_ADDRESS, &sensor);
+
+    TEST_ASSERT_TRUE(dht20Sensor.read(temperature, humidity));
+}
+
+void test_dht20_behind_missing_mux_fails()
+{
+    Dht20ZoneSensor dht20Sensor;
+    dht20Sensor.attach(&dht20, 3);
+    float temperature = 0, humidity = 0;
+
+    TEST_ASSERT_FALSE(dht20Sensor.read(temperature, humidity));
+    TEST_ASSERT_EQUAL_UINT32(0, sensor.triggers);
+}
+
+// A sensor that keeps answering busy never delivers a reading, so the interlock declares it stale
+// and cuts the heater from the interrupt, the loop and the screen follow
+void test_stale_sensor_cuts_heater()
+{
+    EEPROM.put(0, 45.0f);                 // Target temperature
+    EEPROM.put(4, (unsigned short)30);    // Target humidity
+    EEPROM.put(16, TemperatureUnit::Celsius);
+    zones[0].heaterOn = false; // As after power up
+    setup();
+    run(2000);
+    toggleHeaterSetting();
+    TEST_ASSERT_TRUE(zones[0].heaterOn);
+
+    run(10000);
+    TEST_ASSERT_TRUE(zones[0].heaterRunning);
+    TEST_ASSERT_EQUAL_UINT8(HEATER_FULL_DUTY, heaterDuty(0));
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+
+    sensor.busy = true;
+    unsigned long failedAt = nativeTime;
+    while (!(interlockFaults(0) & FaultStaleSensor) && nativeTime - failedAt < 2 * SENSOR_STALE_TIMEOUT)
+        run(INTERLOCK_TICK_MS);
+    unsigned long staleAfter = nativeTime - failedAt;
+
+    TEST_ASSERT_TRUE(interlockFaults(0) & FaultStaleSensor);
+    TEST_ASSERT_LESS_OR_EQUAL(SENSOR_STALE_TIMEOUT, staleAfter);
+    TEST_ASSERT_GREATER_OR_EQUAL(SENSOR_STALE_TIMEOUT - SENSOR_MAX_INTERVAL, staleAfter);
+    TEST_ASSERT_EQUAL_UINT8(0, heaterDuty(0));
+    TEST_ASSERT_EQUAL_UINT8(LOW, nativePinLevel[zones[0].heaterPin]);
+
+    run(SENSOR_MIN_INTERVAL + 100);
+    TEST_ASSERT_FALSE(zones[0].heaterRunning);
+    TEST_ASSERT_TRUE(display.frame.find("SENSOR") != std::string::npos);
+
+    // A stale sensor is not latched, the heater comes back with the readings
+    sensor.busy = false;
+    run(SENSOR_MIN_INTERVAL + 100);
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+    TEST_ASSERT_TRUE(zones[0].heaterRunning);
+}
+
+// A calibration that reads the box far cooler than the sensor does still has the heater cut off at the raw limit
+void test_calibration_cannot_lift_the_cutoff()
+{
+    EEPROM.put(0, 45.0f);
+    EEPROM.put(4, (unsigned short)30);
+    EEPROM.put(16, TemperatureUnit::Celsius);
+    zones[0].heaterOn = false;
+    setup();
+    zones[0].temperatureCalibration.gain = CALIBRATION_MIN_GAIN;
+    zones[0].temperatureCalibration.offset = -CALIBRATION_MAX_OFFSET;
+    run(2000);
+    toggleHeaterSetting();
+    TEST_ASSERT_TRUE(zones[0].heaterOn);
+
+    sensor.temperature = ABSOLUTE_MAX_TEMP - 1;
+    run(SENSOR_MAX_INTERVAL + 100);
+    TEST_ASSERT_EQUAL_UINT8(0, interlockFaults(0));
+
+    sensor.temperature = ABSOLUTE_MAX_TEMP + 1; // Calibrated 46.8 C
+    run(SENSOR_MAX_INTERVAL + 100);
+    TEST_ASSERT_LESS_THAN_FLOAT(ABSOLUTE_MAX_TEMP, zones[0].temperature);
+    TEST_ASSERT_TRUE(interlockFaults(0) & FaultOverTemperature);
+    TEST_ASSERT_EQUAL_UINT8(0, heaterDuty(0));
+    TEST_ASSERT_EQUAL_UINT8(LOW, nativePinLevel[zones[0].heaterPin]);
+    TEST_ASSERT_FALSE(zones[0].heaterRunning);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sample_only_sets_the_reference);
+    RUN_TEST(test_heating_from_cold_keeps_the_watch_happy);
+    RUN_TEST(test_dead_heater_far_below_target_faults);
+    RUN_TEST(test_heater_crawling_near_the_band_is_not_runaway);
+    RUN_TEST(test_drop_below_the_band_while_heating_faults);
+    RUN_TEST(test_drop_that_recovers_is_not_runaway);
+    RUN_TEST(test_rise_while_off_faults);
+    RUN_TEST(test_dht20_reading_is_decoded);
+    RUN_TEST(test_dht20_rejects_bad_frames);
+    RUN_TEST(test_dht20_behind_missing_mux_fails);
+    RUN_TEST(test_stale_sensor_cuts_heater);
+    RUN_TEST(test_calibration_cannot_lift_the_cutoff);
+    return UNITY_END();
+}
@@ -0,0 +1,70 @@
+#include <Adafruit_SSD1306.h>
+#include <native.h>
+#include <unity.h>
+
+#include "drybox.h"
+#include "power.h"
+#include "screen.h"
+
+void setup();
+
+static NativeDht20 sensor;
+
+void setUp()
+{
+    nativeI2cAttach(NATIVE_DHT20_ADDRESS, &sensor);
+}
+
+void tearDown()
+{
+}
+
+// A loop pass every 100 ms like loop() does
+static void run(unsigned long ms, bool onOff = false)
+{
+    unsigned long end = nativeTime + ms;
+    while ((long)(end - nativeTime) > 0)
+    {
+        loopPass(nativeTime, onOff, false, false);
+        idleUntil(currentTime + 100);
+    }
+}
+
+void test_unchanged_screen_is_not_redrawn_every_pass()
+{
+    setup();
+    run(2000);
+    unsigned long frames = display.frames;
+    run(20000);
+
+    // Ten passes a second, but only the refresh and the sensor readings push a frame
+    unsigned long pushed = display.frames - frames;
+    TEST_ASSERT_LESS_OR_EQUAL(20000 / DISPLAY_REFRESH_INTERVAL + 20000 / SENSOR_MIN_INTERVAL + 1, pushed);
+    TEST_ASSERT_GREATER_OR_EQUAL(20000 / DISPLAY_REFRESH_INTERVAL - 1, pushed);
+}
+
+void test_button_redraws_at_once()
+{
+    run(2000);
+    unsigned long frames = display.frames;
+    loopPass(nativeTime, false, true, false); // Up
+    TEST_ASSERT_EQUAL_UINT32(frames + 1, display.frames);
+}
+
+void test_blank_display_gets_no_frames()
+{
+    run(DISPLAY_OFF_TIMEOUT + 1000);
+    TEST_ASSERT_FALSE(display.on);
+    unsigned long frames = display.frames;
+    run(10000);
+    TEST_ASSERT_EQUAL_UINT32(frames, display.frames);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_unchanged_screen_is_not_redrawn_every_pass);
+    RUN_TEST(test_button_redraws_at_once);
+    RUN_TEST(test_blank_display_gets_no_frames);
+    return UNITY_END();
+}
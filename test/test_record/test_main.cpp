@@ -0,0 +1,117 @@
+#include <EEPROM.h>
+#include <native.h>
+#include <stdio.h>
+#include <unity.h>
+
+#include "drybox.h"
+#include "heater.h"
+#include "interlock.h"
+#include "trace.h"
+
+// Records the session replayed by test_replay: a box that learned its thermal lag on earlier runs heated from cold,
+// cycling around its target, the settings menu opened and closed and the heater switched off again. Run with pio test -e record after a deliberate change of
+// behaviour and commit the new trace together with the change.
+
+#ifndef REPLAY_TRACE_DIR
+#define REPLAY_TRACE_DIR "test/traces"
+#endif
+
+extern "C" void TIMER2_COMPA_vect(void);
+void setup();
+
+static NativePlant plant;
+static NativeDht20 sensor;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// The board's clock: an interlock tick every 10 ms and a loop pass every 100 ms, the sensor follows the box
+static void run(unsigned long ms, bool onOff = false, bool up = false, bool down = false)
+{
+    for (unsigned long elapsed = 0; elapsed < ms; elapsed += INTERLOCK_TICK_MS)
+    {
+        nativeTime += INTERLOCK_TICK_MS;
+        if (nativeTime % 1000 == 0)
+        {
+            plant.run(1000, heaterDuty(0) / 255.0);
+            sensor.temperature = plant.air;
+            sensor.humidity = 55.0 - (plant.air - plant.ambient) * 0.6; // Warmer air holds more water
+        }
+        TIMER2_COMPA_vect();
+        if (nativeTime % 100 == 0)
+            loopPass(nativeTime, onOff, up, down);
+    }
+}
+
+static void press(bool onOff, bool up, bool down, unsigned long ms = 200)
+{
+    run(ms, onOff, up, down);
+    run(300);
+}
+
+void test_record_session()
+{
+    EEPROM.erase();
+    EEPROM.put(0, 45.0f);              // Target temperature
+    EEPROM.put(4, (unsigned short)30); // Target humidity
+    EEPROM.put(16, TemperatureUnit::Celsius);
+    ThermalModel learned; // What this box learns in one such session
+    learned.overshoot = 1.0;
+    learned.undershoot = 0.05;
+    learned.cycles = THERMAL_MIN_CYCLES;
+    learned.seeded = ThermalOvershoot | ThermalUndershoot;
+    EEPROM.put(thermalEepromAddress(0), learned);
+    nativeI2cAttach(NATIVE_DHT20_ADDRESS, &sensor);
+    sensor.temperature = plant.air;
+    nativeTime = 1000;
+    setup();
+    run(2000);
+
+    press(true, false, false); // Heater on
+    run(45 * 60000UL);
+
+    press(true, false, false);       // Wakes the blank display, swallowed
+    press(true, false, false, 1500); // Long press opens the settings menu
+    press(false, false, true);       // 2) Target Temp
+    press(false, false, true);       // 3) Target Hum
+    run(5000);
+    press(true, false, false, 1500); // Back to the main screen
+    run(10 * 60000UL);
+
+    press(false, true, false); // Wakes the display again
+    press(true, false, false); // Heater off
+    run(10 * 60000UL);
+
+    FILE *file = fopen(REPLAY_TRACE_DIR "/heat_cycle.trace", "w");
+    TEST_ASSERT_NOT_NULL(file);
+    unsigned long lines = 0;
+    size_t start = 0;
+    while (start < Serial.output.size())
+    {
+        size_t end = Serial.output.find('\n', start);
+        if (end == std::string::npos)
+            end = Serial.output.size();
+        std::string line = Serial.output.substr(start, end - start);
+        if (line.compare(0, strlen(TRACE_PREFIX), TRACE_PREFIX) == 0)
+        {
+            fputs(line.c_str(), file);
+            fputc('\n', file);
+            lines++;
+        }
+        start = end + 1;
+    }
+    fclose(file);
+    TEST_ASSERT_GREATER_THAN(100, lines);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_record_session);
+    return UNITY_END();
+}
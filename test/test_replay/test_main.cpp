@@ -0,0 +1,172 @@
+#include <Adafruit_SSD1306.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "drybox.h"
+#include "screen.h"
+#include "trace.h"
+
+// Replays test/traces/heat_cycle.trace (recorded by test_record) and checks that the controller still produces the
+// recorded heater switches and menu changes, and what the screen showed on the way
+
+#ifndef REPLAY_TRACE_DIR
+#define REPLAY_TRACE_DIR "test/traces"
+#endif
+#define TRACE_FILE REPLAY_TRACE_DIR "/heat_cycle.trace"
+
+static ReplayResult result;
+static unsigned long heaterSwitches = 0;
+static bool lastHeaterRunning = false;
+static bool cycling = false; // Heater switched off at the top of the band once
+static float lowest = 100, highest = -100;
+static bool menuShown = false;
+static bool heatingShown = false;
+static bool started = false;
+static ThermalModel startModel; // Zone 0 after the first pass, before anything was learned
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void afterPass(unsigned long)
+{
+    const Zone &zone = zones[0];
+    if (!started)
+    {
+        startModel = zone.thermal;
+        started = true;
+    }
+    if (zone.heaterRunning != lastHeaterRunning)
+    {
+        heaterSwitches++;
+        lastHeaterRunning = zone.heaterRunning;
+        cycling = cycling || (!zone.heaterRunning && zone.heaterOn);
+    }
+    if (cycling && zone.heaterOn)
+    {
+        lowest = min(lowest, zone.temperature);
+        highest = max(highest, zone.temperature);
+    }
+
+    if (deviceState == MainMenu && display.frame.find("3) Target Hum") != std::string::npos)
+        menuShown = true;
+    if (deviceState == MainScreen && zone.heaterRunning && display.frame.find('^') != std::string::npos)
+        heatingShown = true;
+}
+
+void test_recorded_session_replays_without_divergence()
+{
+    FILE *file = fopen(TRACE_FILE, "r");
+    TEST_ASSERT_NOT_NULL(file);
+    result = replayRun(file, afterPass);
+    fclose(file);
+
+    if (result.divergences)
+        printf("%s", Serial.output.c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, result.divergences);
+    TEST_ASSERT_GREATER_THAN(100, result.passes);
+}
+
+void test_heater_cycles_within_the_band()
+{
+    // Heated up, two switches per cycle, switched off by the user at the end
+    TEST_ASSERT_EQUAL_UINT32(6, heaterSwitches);
+    TEST_ASSERT_FALSE(zones[0].heaterOn);
+    TEST_ASSERT_FALSE(zones[0].heaterRunning);
+
+    TEST_ASSERT_GREATER_THAN_FLOAT(zones[0].targetTemp - 2 * HEATER_HYSTERESIS, lowest);
+    TEST_ASSERT_LESS_THAN_FLOAT(zones[0].targetTemp + 2 * HEATER_HYSTERESIS, highest);
+}
+
+void test_screen_follows_the_session()
+{
+    TEST_ASSERT_TRUE(heatingShown);
+    TEST_ASSERT_TRUE(menuShown);
+    TEST_ASSERT_EQUAL(MainScreen, deviceState);
+    TEST_ASSERT_TRUE(display.frame.find('^') == std::string::npos);
+    TEST_ASSERT_TRUE(display.frame.find("C\n") != std::string::npos); // Temperature in Celsius as recorded
+}
+
+// The box was recorded with the model it learned on earlier runs, the replay has to start from all of it
+void test_learned_model_is_restored()
+{
+    TEST_ASSERT_EQUAL_UINT8(ThermalOvershoot | ThermalUndershoot, startModel.seeded);
+    TEST_ASSERT_EQUAL_UINT8(THERMAL_MIN_CYCLES, startModel.cycles);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 1.0, startModel.overshoot);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.05, startModel.undershoot);
+}
+
+static std::string readTrace()
+{
+    FILE *file = fopen(TRACE_FILE, "r");
+    TEST_ASSERT_NOT_NULL(file);
+    std::string trace;
+    char line[128];
+    while (fgets(line, sizeof(line), file))
+        trace += line;
+    fclose(file);
+    return trace;
+}
+
+// A recording the controller no longer agrees with must be reported. The edited trace is replayed in a child
+// process that starts from the state at boot like the recording did, so these run before the unedited trace is
+// replayed here.
+static void assertDiverges(std::string &trace)
+{
+    fflush(stdout);
+    pid_t child = fork();
+    TEST_ASSERT_TRUE(child >= 0);
+    if (child == 0)
+    {
+        Serial.output.clear();
+        FILE *edited = fmemopen((void *)trace.data(), trace.size(), "r");
+        ReplayResult edit = replayRun(edited, nullptr);
+        fclose(edited);
+        bool reported = Serial.output.find("$DIV,") != std::string::npos;
+        _exit(reported ? min(edit.divergences, 255UL) : 0);
+    }
+
+    int status = 0;
+    TEST_ASSERT_EQUAL(child, waitpid(child, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_GREATER_OR_EQUAL(1, WEXITSTATUS(status));
+}
+
+// One heater switch dropped from the recording
+void test_missing_output_is_a_divergence()
+{
+    std::string trace = readTrace();
+    size_t heater = trace.find("\n$TRC,40");
+    TEST_ASSERT_TRUE(heater != std::string::npos);
+    trace.erase(heater + 1, trace.find('\n', heater + 1) - heater);
+    assertDiverges(trace);
+}
+
+// The learned values taken for first measurements, the box then learns a different lag than the recorded one
+void test_unseeded_model_is_a_divergence()
+{
+    std::string trace = readTrace();
+    TEST_ASSERT_EQUAL(0, trace.compare(0, strlen(TRACE_PREFIX) + 2, TRACE_PREFIX "00")); // Start of zone 0
+    size_t seeded = strlen(TRACE_PREFIX) + 2 * (3 + offsetof(TraceStartPayload, seeded));
+    trace.replace(seeded, 2, "00");
+    assertDiverges(trace);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_missing_output_is_a_divergence);
+    RUN_TEST(test_unseeded_model_is_a_divergence);
+    RUN_TEST(test_recorded_session_replays_without_divergence);
+    RUN_TEST(test_heater_cycles_within_the_band);
+    RUN_TEST(test_screen_follows_the_session);
+    RUN_TEST(test_learned_model_is_restored);
+    return UNITY_END();
+}
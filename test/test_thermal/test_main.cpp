@@ -0,0 +1,123 @@
+#include <EEPROM.h>
+#include <native.h>
+#include <unity.h>
+
+#include "drybox.h"
+#include "thermal.h"
+
+#define SAMPLE_INTERVAL 5000UL
+#define RUN_TIME (8 * 3600000UL)
+
+void setUp()
+{
+    EEPROM.erase();
+    zones[0] = Zone();
+    zones[0].heaterOn = true;
+    zones[0].targetTemp = 45;
+    zones[0].targetHumidity = 10;
+    zones[0].humidity = 50; // Always wetter than the target, only the temperature decides
+    thermalLoad();
+}
+
+void tearDown()
+{
+}
+
+// Feeds one sample and applies the heater demand the way sensorUpdate does
+static void sample(float temperature, bool learning = true)
+{
+    zones[0].temperature = temperature;
+    if (learning)
+        thermalLearn(0, temperature, zones[0].heaterRunning);
+    zones[0].heaterRunning = zoneHeaterDemand(zones[0]);
+}
+
+// Temperature swing of the simulated box over the second half of an 8 h run
+static float peakToPeak(float elementCapacity, bool learning)
+{
+    NativePlant plant;
+    plant.elementCapacity = elementCapacity;
+    float lowest = 100, highest = -100;
+
+    for (unsigned long elapsed = 0; elapsed < RUN_TIME; elapsed += SAMPLE_INTERVAL)
+    {
+        plant.run(SAMPLE_INTERVAL, zones[0].heaterRunning ? 1.0 : 0.0);
+        sample(plant.air, learning);
+        if (elapsed >= RUN_TIME / 2)
+        {
+            lowest = min(lowest, plant.air);
+            highest = max(highest, plant.air);
+        }
+    }
+    return highest - lowest;
+}
+
+void test_each_value_is_seeded_by_its_first_measurement()
+{
+    // Switched on at 40.0 heating up from cold, trough 0.5 below that
+    sample(40.0);
+    sample(39.7);
+    sample(39.5);
+    sample(39.8);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.5, zones[0].thermal.undershoot);
+    TEST_ASSERT_EQUAL_UINT8(ThermalUndershoot, zones[0].thermal.seeded);
+
+    // Switched off at 46.6, which completes the first cycle, peak 1.2 above that
+    sample(46.6);
+    sample(47.2);
+    sample(47.8);
+    sample(47.5);
+    TEST_ASSERT_EQUAL_UINT8(1, zones[0].thermal.cycles);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 1.2, zones[0].thermal.overshoot); // Not averaged in from 0
+    TEST_ASSERT_EQUAL_UINT8(ThermalOvershoot | ThermalUndershoot, zones[0].thermal.seeded);
+
+    // Switched on again at 43.4, trough 0.3 below that is averaged into the seeded undershoot
+    sample(43.4);
+    sample(43.1);
+    sample(43.4);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.5 + (0.3 - 0.5) / 4, zones[0].thermal.undershoot);
+}
+
+void test_model_survives_eeprom()
+{
+    zones[0].thermal.overshoot = 1.25;
+    zones[0].thermal.cycles = 3;
+    zones[0].thermal.seeded = ThermalOvershoot;
+    EEPROM.put(thermalEepromAddress(0), zones[0].thermal);
+
+    zones[0].thermal = ThermalModel();
+    thermalLoad();
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 1.25, zones[0].thermal.overshoot);
+    TEST_ASSERT_EQUAL_UINT8(ThermalOvershoot, zones[0].thermal.seeded);
+}
+
+// The simulated box behind the numbers in the README: a fixed band lets the lag carry the temperature past both
+// edges, the learned switch points keep the swing close to the band
+void test_learned_lag_narrows_the_swing()
+{
+    const float elementCapacities[] = {300, 600, 1200};
+    for (float elementCapacity : elementCapacities)
+    {
+        setUp();
+        float fixed = peakToPeak(elementCapacity, false);
+        setUp();
+        float learned = peakToPeak(elementCapacity, true);
+
+        char message[100];
+        snprintf(message, sizeof(message), "element %.0f J/K: fixed %.2f C, learned %.2f C, overshoot %.2f C",
+                 elementCapacity, fixed, learned, zones[0].thermal.overshoot);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_GREATER_THAN_FLOAT(2 * HEATER_HYSTERESIS + 0.2, fixed);
+        TEST_ASSERT_LESS_THAN_FLOAT(2 * HEATER_HYSTERESIS + 0.2, learned);
+        TEST_ASSERT_LESS_THAN_FLOAT(fixed, learned);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_each_value_is_seeded_by_its_first_measurement);
+    RUN_TEST(test_model_survives_eeprom);
+    RUN_TEST(test_learned_lag_narrows_the_swing);
+    return UNITY_END();
+}
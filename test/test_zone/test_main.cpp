@@ -0,0 +1,230 @@
+#include <unity.h>
+
+#include "zone.h"
+
+// Hands out whatever reading the test put in, or nothing
+class MockZoneSensor : public ZoneSensor
+{
+public:
+    bool answers = true;
+    float temperature = 25.0;
+    float humidity = 50.0;
+    unsigned long reads = 0;
+
+    bool begin() override
+    {
+        return answers;
+    }
+
+    bool read(float &temperature, float &humidity) override
+    {
+        reads++;
+        if (!answers)
+            return false;
+        temperature = this->temperature;
+        humidity = this->humidity;
+        return true;
+    }
+};
+
+static MockZoneSensor sensor;
+static Zone zone;
+
+void setUp()
+{
+    sensor = MockZoneSensor();
+    zone = Zone();
+    zone.sensor = &sensor;
+    zone.heaterOn = true;
+    zone.targetTemp = 45;
+    zone.targetHumidity = 30;
+}
+
+void tearDown()
+{
+}
+
+// Feeds one reading and applies the heater demand the way toggleHeater does
+static bool sample(float temperature, float humidity = 50.0)
+{
+    sensor.temperature = temperature;
+    sensor.humidity = humidity;
+    TEST_ASSERT_TRUE(zoneSample(zone));
+    zone.heaterRunning = zoneHeaterDemand(zone);
+    return zone.heaterRunning;
+}
+
+void test_sample_keeps_raw_reading_and_calibrates()
+{
+    zone.temperatureCalibration.offset = 100; // +1.00 C
+    sensor.temperature = 25.004;
+    sensor.humidity = 50.006;
+
+    TEST_ASSERT_TRUE(zoneSample(zone));
+    TEST_ASSERT_EQUAL_INT16(2500, zone.rawTemperature);
+    TEST_ASSERT_EQUAL_INT16(5001, zone.rawHumidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 26.0, zone.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 50.01, zone.humidity);
+}
+
+void test_failed_sample_keeps_last_reading()
+{
+    sample(40.0);
+    sensor.answers = false;
+
+    TEST_ASSERT_FALSE(zoneSample(zone));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 40.0, zone.temperature);
+    TEST_ASSERT_EQUAL_INT16(4000, zone.rawTemperature);
+}
+
+void test_heater_switches_at_band_edges()
+{
+    // Heating up from cold, the heater stays on through the band until it is left at the top
+    TEST_ASSERT_TRUE(sample(40.0));
+    TEST_ASSERT_TRUE(sample(43.6));
+    TEST_ASSERT_TRUE(sample(46.4));
+    TEST_ASSERT_FALSE(sample(46.6));
+
+    // Cooling down, it stays off through the band until it is left at the bottom
+    TEST_ASSERT_FALSE(sample(45.0));
+    TEST_ASSERT_FALSE(sample(43.6));
+    TEST_ASSERT_TRUE(sample(43.4));
+}
+
+void test_no_heat_when_dry_or_disabled()
+{
+    TEST_ASSERT_FALSE(sample(20.0, 30.0)); // At the target humidity
+    TEST_ASSERT_TRUE(sample(20.0, 30.5));
+
+    zone.heaterOn = false;
+    TEST_ASSERT_FALSE(sample(20.0, 80.0));
+}
+
+void test_learned_lag_moves_switch_points()
+{
+    zone.thermal.overshoot = 1.0;
+    zone.thermal.undershoot = 0.5;
+    zone.thermal.cycles = THERMAL_MIN_CYCLES - 1;
+
+    float switchOnAt, switchOffAt;
+    zoneSwitchPoints(zone, switchOnAt, switchOffAt);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43.5, switchOnAt); // Not enough cycles yet
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 46.5, switchOffAt);
+
+    zone.thermal.cycles = THERMAL_MIN_CYCLES;
+    zoneSwitchPoints(zone, switchOnAt, switchOffAt);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 44.0, switchOnAt);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 45.5, switchOffAt);
+
+    // A lag wider than the band still leaves a minimum gap around its middle
+    zone.thermal.overshoot = 3.0;
+    zone.thermal.undershoot = 3.0;
+    zoneSwitchPoints(zone, switchOnAt, switchOffAt);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 45.0 - THERMAL_MIN_SWITCH_GAP / 2, switchOnAt);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 45.0 + THERMAL_MIN_SWITCH_GAP / 2, switchOffAt);
+}
+
+void test_zones_follow_their_own_targets()
+{
+    MockZoneSensor sensors[2];
+    Zone zones[2];
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        zones[i].sensor = &sensors[i];
+        zones[i].heaterOn = true;
+        sensors[i].temperature = 42.0;
+        sensors[i].humidity = 50.0;
+    }
+    zones[0].targetTemp = 45;
+    zones[0].targetHumidity = 30;
+    zones[1].targetTemp = 40;
+    zones[1].targetHumidity = 30;
+
+    for (uint8_t i = 0; i < 2; i++)
+        TEST_ASSERT_TRUE(zoneSample(zones[i]));
+    TEST_ASSERT_TRUE(zoneHeaterDemand(zones[0]));  // 42 is below 45 - 1.5
+    TEST_ASSERT_FALSE(zoneHeaterDemand(zones[1])); // 42 is above 40 + 1.5
+
+    zones[1].targetTemp = 45;
+    zones[1].targetHumidity = 55; // Already drier than this zone asks for
+    TEST_ASSERT_TRUE(zoneHeaterDemand(zones[0]));
+    TEST_ASSERT_FALSE(zoneHeaterDemand(zones[1]));
+}
+
+void test_reads_are_staggered()
+{
+    const uint8_t count = 3;
+    Zone zones[count];
+    unsigned long lastRead = 0;
+    unsigned long lastZoneRead[count] = {0, 0, 0};
+    uint8_t expectedZone = 0;
+    unsigned long reads = 0;
+
+    // Passes every 100 ms like loop(), every zone on the shortest interval
+    for (unsigned long now = 100; now <= 60000; now += 100)
+    {
+        uint8_t next = zoneNextDue(zones, count, lastRead, now);
+        if (next == count)
+            continue;
+
+        TEST_ASSERT_EQUAL_UINT8(expectedZone, next);                         // Round robin, no zone starves
+        TEST_ASSERT_GREATER_OR_EQUAL(SENSOR_MIN_INTERVAL / count, now - lastRead); // Never two reads back to back
+        TEST_ASSERT_GREATER_OR_EQUAL(SENSOR_MIN_INTERVAL, now - zones[next].lastSampleTime);
+        if (reads >= count)
+            TEST_ASSERT_LESS_OR_EQUAL(SENSOR_MIN_INTERVAL + 100, now - lastZoneRead[next]);
+
+        zones[next].lastSampleTime = now;
+        lastZoneRead[next] = now;
+        lastRead = now;
+        expectedZone = (expectedZone + 1) % count;
+        reads++;
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL((60000 / (SENSOR_MIN_INTERVAL + 100) - 1) * count, reads);
+}
+
+void test_most_overdue_zone_goes_first()
+{
+    Zone zones[3];
+    zones[0].sampleInterval = 10000;
+    zones[0].lastSampleTime = 0;
+    zones[1].sampleInterval = 2000;
+    zones[1].lastSampleTime = 5000; // 3 s overdue at 10 s
+    zones[2].sampleInterval = 2000;
+    zones[2].lastSampleTime = 7000; // 1 s overdue
+
+    TEST_ASSERT_EQUAL_UINT8(1, zoneNextDue(zones, 3, 9000, 10000));
+    TEST_ASSERT_EQUAL_UINT8(3, zoneNextDue(zones, 3, 9500, 10000)); // Too soon after the previous read
+}
+
+void test_interval_stretches_while_stable_and_snaps_back()
+{
+    sample(35.0, 50.0); // Far from the switch points
+    for (uint8_t i = 0; i < 10; i++)
+        zoneAdaptInterval(zone, zone.temperature, zone.humidity, zone.sampleInterval);
+    TEST_ASSERT_EQUAL_UINT32(SENSOR_MAX_INTERVAL, zone.sampleInterval);
+
+    float lastTemperature = zone.temperature;
+    sample(37.0, 50.0); // 2 C in one interval
+    zoneAdaptInterval(zone, lastTemperature, zone.humidity, SENSOR_MAX_INTERVAL);
+    TEST_ASSERT_LESS_THAN(SENSOR_MAX_INTERVAL, zone.sampleInterval);
+
+    lastTemperature = zone.temperature;
+    sample(43.4, 50.0); // Right at the switch on point and still moving
+    zoneAdaptInterval(zone, lastTemperature, zone.humidity, zone.sampleInterval);
+    TEST_ASSERT_EQUAL_UINT32(SENSOR_MIN_INTERVAL, zone.sampleInterval);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_keeps_raw_reading_and_calibrates);
+    RUN_TEST(test_failed_sample_keeps_last_reading);
+    RUN_TEST(test_heater_switches_at_band_edges);
+    RUN_TEST(test_no_heat_when_dry_or_disabled);
+    RUN_TEST(test_learned_lag_moves_switch_points);
+    RUN_TEST(test_zones_follow_their_own_targets);
+    RUN_TEST(test_reads_are_staggered);
+    RUN_TEST(test_most_overdue_zone_goes_first);
+    RUN_TEST(test_interval_stretches_while_stable_and_snaps_back);
+    return UNITY_END();
+}
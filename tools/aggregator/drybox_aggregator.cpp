@@ -0,0 +1,548 @@
+/*
+Host side aggregator for a fleet of drybox controllers.
+
+Opens every given serial device, multiplexes them with epoll on a single thread and picks the
+"$DBX,..." status lines out of the regular debug output. Every box/zone keeps an in-memory time
+series, every reading is appended to a compact binary log and a fleet summary is rewritten
+periodically. Boxes are known by their device path, the log names them at the start of every run,
+so use the stable /dev/serial/by-id/... paths.
+
+Build:  g++ -O2 -std=c++17 -o drybox-aggregator tools/aggregator/drybox_aggregator.cpp
+Usage:  drybox-aggregator [-l log] [-s summary] [-i seconds] [-n samples] device...
+        drybox-aggregator -d log    (print a log as CSV)
+
+Pseudo-terminals work as devices, which is how the aggregator can be exercised without hardware.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#define STATUS_PREFIX "$DBX,"
+#define LINE_MAX_LENGTH 128
+#define MAX_ZONES 8
+#define RECONNECT_INTERVAL 5 // Seconds between attempts to reopen a lost device
+
+static const char LOG_MAGIC[8] = {'D', 'B', 'X', 'L', 'O', 'G', '2', '\n'};
+
+// Records of the log after the magic, each one starts with its type byte
+enum LogRecord : uint8_t {
+    LogBoxName = 'B', // uint16 box, uint8 length, device path: names the box for the samples that follow
+    LogSample = 'S'   // Sample
+};
+
+// One reading, also the on-disk log record
+struct __attribute__((packed)) Sample
+{
+    uint32_t time;         // Unix time in seconds
+    uint16_t box;          // Index of the device on the command line, named by the last LogBoxName record
+    uint8_t zone;
+    uint8_t flags;         // Bit 0 heater on, bit 1 heater running
+    int16_t temperature;   // 0.1 C
+    uint16_t humidity;     // 0.1 %
+    int16_t targetTemp;    // 0.1 C
+    uint16_t targetHumidity; // %
+    uint8_t faults;        // Interlock fault bits
+    uint16_t interval;     // Sample interval in ms
+};
+
+enum SampleFlags : uint8_t {
+    HeaterOnFlag = 1,
+    HeaterRunningFlag = 2
+};
+
+// Interlock fault bits of the firmware (include/interlock.h)
+static const char *const FAULT_NAMES[] = {"overtemp", "sensor", "runaway-heating", "runaway-cooling", "loop-stall"};
+
+// Fixed size ring of the latest samples of one zone
+struct Series
+{
+    std::vector<Sample> samples;
+    size_t next = 0;
+    size_t count = 0;
+
+    void add(const Sample &sample)
+    {
+        samples[next] = sample;
+        next = (next + 1) % samples.size();
+        if (count < samples.size())
+            count++;
+    }
+
+    const Sample &latest() const
+    {
+        return samples[(next + samples.size() - 1) % samples.size()];
+    }
+
+    const Sample &at(size_t i) const // 0 is the oldest sample kept
+    {
+        return samples[(next + samples.size() - count + i) % samples.size()];
+    }
+};
+
+struct Box
+{
+    std::string path;
+    int fd = -1;
+    char line[LINE_MAX_LENGTH];
+    size_t lineLength = 0;
+    bool lineOverflow = false;
+    Series zones[MAX_ZONES];
+};
+
+static std::vector<Box> boxes;
+static int epollFd = -1;
+static FILE *logFile = nullptr;
+static volatile sig_atomic_t running = 1;
+
+static void stop(int)
+{
+    running = 0;
+}
+
+static bool openBox(Box &box)
+{
+    int fd = open(box.path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    // Raw 8N1 at the controller's 115200 baud, pseudo-terminals accept the same settings
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u32 = &box - boxes.data();
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    box.fd = fd;
+    box.lineLength = 0;
+    box.lineOverflow = false;
+    return true;
+}
+
+static void closeBox(Box &box)
+{
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, box.fd, nullptr);
+    close(box.fd);
+    box.fd = -1;
+    fprintf(stderr, "%s: disconnected\n", box.path.c_str());
+}
+
+// Parses "$DBX,zone,temp,hum,targetTemp,targetHum,heaterOn,heaterRunning[,faults,interval[,...]]"
+static bool parseStatus(const char *line, Sample &sample)
+{
+    if (strncmp(line, STATUS_PREFIX, strlen(STATUS_PREFIX)) != 0)
+        return false;
+
+    long fields[9] = {};
+    int count = 0;
+    const char *p = line + strlen(STATUS_PREFIX);
+    while (count < 9 && *p)
+    {
+        char *end;
+        errno = 0;
+        fields[count] = strtol(p, &end, 10);
+        if (end == p || errno != 0 || (*end != ',' && *end != '\0'))
+            return false;
+        count++;
+        p = *end == ',' ? end + 1 : end;
+    }
+
+    // Firmware without the interlock sends the first 7 fields only
+    if (count < 7 || fields[0] < 0 || fields[0] >= MAX_ZONES || fields[2] < 0 || fields[4] < 0)
+        return false;
+    if (fields[7] < 0 || fields[7] > UINT8_MAX || fields[8] < 0 || fields[8] > UINT16_MAX)
+        return false;
+
+    sample.zone = fields[0];
+    sample.temperature = fields[1];
+    sample.humidity = fields[2];
+    sample.targetTemp = fields[3];
+    sample.targetHumidity = fields[4];
+    sample.flags = (fields[5] ? HeaterOnFlag : 0) | (fields[6] ? HeaterRunningFlag : 0);
+    sample.faults = fields[7];
+    sample.interval = fields[8];
+    return true;
+}
+
+static void logBoxName(uint16_t box, const std::string &path)
+{
+    uint8_t length = path.size() < UINT8_MAX ? path.size() : UINT8_MAX;
+    fputc(LogBoxName, logFile);
+    fwrite(&box, sizeof(box), 1, logFile);
+    fputc(length, logFile);
+    fwrite(path.data(), 1, length, logFile);
+}
+
+// Names of the set fault bits separated by '+', "-" for none
+static std::string faultNames(uint8_t faults)
+{
+    std::string names;
+    for (size_t bit = 0; bit < sizeof(FAULT_NAMES) / sizeof(FAULT_NAMES[0]); bit++)
+    {
+        if (!(faults & (1 << bit)))
+            continue;
+        if (!names.empty())
+            names += '+';
+        names += FAULT_NAMES[bit];
+    }
+    if (faults >> (sizeof(FAULT_NAMES) / sizeof(FAULT_NAMES[0])))
+        names += names.empty() ? "unknown" : "+unknown";
+    return names.empty() ? "-" : names;
+}
+
+static void handleLine(Box &box)
+{
+    Sample sample;
+    if (!parseStatus(box.line, sample))
+        return; // Regular debug output of the controller or a garbled line
+
+    sample.time = time(nullptr);
+    sample.box = &box - boxes.data();
+    box.zones[sample.zone].add(sample);
+
+    if (logFile)
+    {
+        fputc(LogSample, logFile);
+        fwrite(&sample, sizeof(sample), 1, logFile);
+    }
+}
+
+static void readBox(Box &box)
+{
+    char buffer[4096];
+    for (;;)
+    {
+        ssize_t length = read(box.fd, buffer, sizeof(buffer));
+        if (length < 0 && errno == EINTR)
+            continue;
+        if (length < 0 && errno == EAGAIN)
+            return;
+        if (length <= 0)
+        {
+            closeBox(box);
+            return;
+        }
+
+        for (ssize_t i = 0; i < length; i++)
+        {
+            char c = buffer[i];
+            if (c == '\n' || c == '\r')
+            {
+                if (box.lineLength > 0 && !box.lineOverflow)
+                {
+                    box.line[box.lineLength] = '\0';
+                    handleLine(box);
+                }
+                box.lineLength = 0;
+                box.lineOverflow = false;
+            }
+            else if (box.lineLength < LINE_MAX_LENGTH - 1)
+            {
+                box.line[box.lineLength++] = c;
+            }
+            else
+            {
+                box.lineOverflow = true; // Garbage or a line we do not know, drop it
+            }
+        }
+    }
+}
+
+static void writeSummary(const char *path)
+{
+    std::string tmpPath = std::string(path) + ".tmp";
+    FILE *f = fopen(tmpPath.c_str(), "w");
+    if (!f)
+    {
+        perror(tmpPath.c_str());
+        return;
+    }
+
+    time_t now = time(nullptr);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    fprintf(f, "# drybox fleet summary %s\n", stamp);
+    fprintf(f, "%-24s %4s %7s %6s %7s %6s %-7s %6s %7s %7s %s\n",
+            "device", "zone", "temp", "hum", "t_temp", "t_hum", "heater", "age_s", "hum_min", "hum_max", "faults");
+
+    for (const Box &box : boxes)
+    {
+        bool any = false;
+        for (int zone = 0; zone < MAX_ZONES; zone++)
+        {
+            const Series &series = box.zones[zone];
+            if (series.count == 0)
+                continue;
+            any = true;
+
+            int humidityMin = 0xFFFF, humidityMax = 0;
+            for (size_t i = 0; i < series.count; i++)
+            {
+                int humidity = series.at(i).humidity;
+                humidityMin = humidity < humidityMin ? humidity : humidityMin;
+                humidityMax = humidity > humidityMax ? humidity : humidityMax;
+            }
+
+            const Sample &latest = series.latest();
+            const char *heater = !(latest.flags & HeaterOnFlag) ? "off"
+                                 : (latest.flags & HeaterRunningFlag) ? "heating" : "on";
+            fprintf(f, "%-24s %4d %7.1f %6.1f %7.1f %6u %-7s %6ld %7.1f %7.1f %s%s\n",
+                    box.path.c_str(), zone, latest.temperature / 10.0, latest.humidity / 10.0,
+                    latest.targetTemp / 10.0, latest.targetHumidity, heater, (long)(now - latest.time),
+                    humidityMin / 10.0, humidityMax / 10.0, faultNames(latest.faults).c_str(),
+                    box.fd < 0 ? " (disconnected)" : "");
+        }
+        if (!any)
+            fprintf(f, "%-24s %4s%s\n", box.path.c_str(), "-", box.fd < 0 ? " (disconnected)" : " (no data)");
+    }
+
+    fclose(f);
+    if (rename(tmpPath.c_str(), path) < 0)
+        perror(path);
+}
+
+// Reads the magic at the start of a log, false if it is not a log of this version
+static bool checkLogMagic(FILE *f, const char *path)
+{
+    char magic[sizeof(LOG_MAGIC)] = {};
+    if (fread(magic, sizeof(magic), 1, f) == 1 && memcmp(magic, LOG_MAGIC, sizeof(magic)) == 0)
+        return true;
+
+    if (memcmp(magic, LOG_MAGIC, sizeof(magic) - 2) == 0)
+        fprintf(stderr, "%s: written by another version of the aggregator, start a new log\n", path);
+    else
+        fprintf(stderr, "%s: not a drybox log\n", path);
+    return false;
+}
+
+static int dumpLog(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        return 1;
+    }
+
+    if (!checkLogMagic(f, path))
+    {
+        fclose(f);
+        return 1;
+    }
+
+    printf("time,box,zone,temperature,humidity,target_temp,target_humidity,heater_on,heater_running,faults,interval_ms\n");
+    std::vector<std::string> names; // Device path of every box index, as of the last LogBoxName record
+    int type;
+    while ((type = fgetc(f)) != EOF)
+    {
+        if (type == LogBoxName)
+        {
+            uint16_t box;
+            int length;
+            char name[UINT8_MAX];
+            if (fread(&box, sizeof(box), 1, f) != 1 || (length = fgetc(f)) == EOF ||
+                fread(name, 1, length, f) != (size_t)length)
+                break;
+            if (names.size() <= box)
+                names.resize(box + 1);
+            names[box].assign(name, length);
+            continue;
+        }
+
+        Sample sample;
+        if (type != LogSample || fread(&sample, sizeof(sample), 1, f) != 1)
+        {
+            fprintf(stderr, "%s: truncated or damaged at byte %ld\n", path, ftell(f));
+            fclose(f);
+            return 1;
+        }
+        std::string box = sample.box < names.size() ? names[sample.box] : std::to_string(sample.box);
+        printf("%u,%s,%u,%.1f,%.1f,%.1f,%u,%d,%d,%u,%u\n", sample.time, box.c_str(), sample.zone,
+               sample.temperature / 10.0, sample.humidity / 10.0, sample.targetTemp / 10.0,
+               sample.targetHumidity, !!(sample.flags & HeaterOnFlag), !!(sample.flags & HeaterRunningFlag),
+               sample.faults, sample.interval);
+    }
+    fclose(f);
+    return 0;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-l log] [-s summary] [-i seconds] [-n samples] device...\n"
+            "       %s -d log\n"
+            "  -l  append every reading to this binary log\n"
+            "  -s  rewrite this fleet summary file periodically (default drybox-summary.txt)\n"
+            "  -i  summary interval in seconds (default 10)\n"
+            "  -n  samples kept in memory per zone (default 2048)\n"
+            "  -d  print a binary log as CSV and exit\n",
+            name, name);
+}
+
+int main(int argc, char **argv)
+{
+    const char *logPath = nullptr;
+    const char *summaryPath = "drybox-summary.txt";
+    long summaryInterval = 10;
+    long seriesLength = 2048;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "l:s:i:n:d:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'l':
+            logPath = optarg;
+            break;
+        case 's':
+            summaryPath = optarg;
+            break;
+        case 'i':
+            summaryInterval = strtol(optarg, nullptr, 10);
+            break;
+        case 'n':
+            seriesLength = strtol(optarg, nullptr, 10);
+            break;
+        case 'd':
+            return dumpLog(optarg);
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc || summaryInterval <= 0 || seriesLength <= 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+    {
+        perror("epoll_create1");
+        return 1;
+    }
+
+    if (logPath)
+    {
+        logFile = fopen(logPath, "a+b");
+        if (!logFile)
+        {
+            perror(logPath);
+            return 1;
+        }
+        fseek(logFile, 0, SEEK_END);
+        if (ftell(logFile) == 0)
+        {
+            fwrite(LOG_MAGIC, sizeof(LOG_MAGIC), 1, logFile);
+        }
+        else
+        {
+            rewind(logFile);
+            if (!checkLogMagic(logFile, logPath))
+                return 1;
+            fseek(logFile, 0, SEEK_END); // Needed between reading and writing, appending goes to the end anyway
+        }
+    }
+
+    // The vector must not reallocate after this point, epoll refers to boxes by index
+    boxes.resize(argc - optind);
+    for (size_t i = 0; i < boxes.size(); i++)
+    {
+        boxes[i].path = argv[optind + i];
+        for (Series &series : boxes[i].zones)
+            series.samples.resize(seriesLength);
+        if (logFile)
+            logBoxName(i, boxes[i].path); // Indexes change with the command line, the names stay valid
+        if (!openBox(boxes[i]))
+            fprintf(stderr, "%s: %s, retrying every %d s\n", boxes[i].path.c_str(), strerror(errno), RECONNECT_INTERVAL);
+    }
+
+    // One second tick drives the summary and reconnects, index past the boxes marks it
+    int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct itimerspec tick = {{1, 0}, {1, 0}};
+    timerfd_settime(timerFd, 0, &tick, nullptr);
+    struct epoll_event timerEvent = {};
+    timerEvent.events = EPOLLIN;
+    timerEvent.data.u32 = UINT32_MAX;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &timerEvent);
+
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+    signal(SIGHUP, SIG_IGN);
+
+    unsigned long ticks = 0;
+    struct epoll_event events[64];
+    while (running)
+    {
+        int count = epoll_wait(epollFd, events, 64, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.u32 != UINT32_MAX)
+            {
+                Box &box = boxes[events[i].data.u32];
+                if (box.fd >= 0)
+                    readBox(box);
+                continue;
+            }
+
+            uint64_t expirations;
+            if (read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations))
+                continue;
+            ticks += expirations;
+
+            if (ticks % summaryInterval < expirations)
+            {
+                writeSummary(summaryPath);
+                if (logFile)
+                    fflush(logFile);
+            }
+            if (ticks % RECONNECT_INTERVAL < expirations)
+            {
+                for (Box &box : boxes)
+                {
+                    if (box.fd < 0 && openBox(box))
+                        fprintf(stderr, "%s: connected\n", box.path.c_str());
+                }
+            }
+        }
+    }
+
+    writeSummary(summaryPath);
+    if (logFile)
+        fclose(logFile);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+Exercises drybox-aggregator against simulated boxes on pseudo-terminals.
+
+Three boxes print debug output mixed with $DBX status lines, one line split across two writes the way a serial
+port delivers it, one box with an interlock fault. One box then goes away. The summary has to show the latest
+readings and faults of every zone with the lost box marked as disconnected. The aggregator is then restarted on
+the same log with the devices in the opposite order, and the log has to dump back every reading under the device
+it came from.
+
+Build:  g++ -O2 -std=c++17 -o drybox-aggregator tools/aggregator/drybox_aggregator.cpp
+Usage:  python3 tools/aggregator/pty_test.py ./drybox-aggregator
+"""
+
+import csv
+import io
+import os
+import pty
+import subprocess
+import sys
+import tempfile
+import time
+
+BOXES = 3
+LOST_BOX = 1
+FAULTY_BOX = 2  # Reports a stale sensor
+SUMMARY_INTERVAL = 1  # Seconds
+
+
+def humidity(box, run):
+    # Every reading tells which box and which aggregator run it came from
+    return 300 + 10 * run + box
+
+
+def status_lines(box, run):
+    # Zone 0 heating, zone 1 switched off and below zero, the second line arrives in two writes
+    faults = 2 if box == FAULTY_BOX else 0
+    first = b"debug\r\n$DBX,0,452,%d,450,30,1,1,%d,2000\r\n$DBX,1,-" % (humidity(box, run), faults)
+    second = b"12,500,450,30,0,0,0,20000\r\n"
+    return first, second
+
+
+def expect(condition, message):
+    if not condition:
+        sys.exit("FAIL: " + message)
+
+
+def run_aggregator(aggregator, log, summary, devices, masters, boxes, run, lose=None):
+    process = subprocess.Popen([aggregator, "-l", log, "-s", summary, "-i", str(SUMMARY_INTERVAL)] + devices)
+    try:
+        time.sleep(0.5)
+        for box in boxes:
+            for chunk in status_lines(box, run):
+                os.write(masters[box], chunk)
+                time.sleep(0.05)
+        time.sleep(1.5)
+
+        if lose is not None:
+            os.close(masters[lose])
+            time.sleep(2 * SUMMARY_INTERVAL + 1)
+    finally:
+        process.terminate()
+        process.wait()
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: %s drybox-aggregator" % sys.argv[0])
+    aggregator = sys.argv[1]
+
+    with tempfile.TemporaryDirectory() as directory:
+        log = os.path.join(directory, "fleet.log")
+        summary = os.path.join(directory, "summary.txt")
+
+        masters, devices = [], []
+        for _ in range(BOXES):
+            master, slave = pty.openpty()
+            masters.append(master)
+            devices.append(os.ttyname(slave))
+
+        run_aggregator(aggregator, log, summary, devices, masters, range(BOXES), 0, lose=LOST_BOX)
+
+        with open(summary) as f:
+            rows = [line.split() for line in f if not line.startswith("#") and not line.startswith("device")]
+        expect(len(rows) == 2 * BOXES, "expected %d summary rows, got %d" % (2 * BOXES, len(rows)))
+        for row in rows:
+            box = devices.index(row[0])
+            zone = int(row[1])
+            if zone == 0:
+                expect(row[2:7] == ["45.2", "%.1f" % (humidity(box, 0) / 10), "45.0", "30", "heating"],
+                       "box %d zone 0: %s" % (box, " ".join(row)))
+                expect(row[10] == ("sensor" if box == FAULTY_BOX else "-"), "box %d faults: %s" % (box, row[10]))
+            else:
+                expect(row[2:7] == ["-1.2", "50.0", "45.0", "30", "off"], "box %d zone 1: %s" % (box, " ".join(row)))
+            expect((row[-1] == "(disconnected)") == (box == LOST_BOX),
+                   "box %d is %s" % (box, "connected" if box == LOST_BOX else "disconnected"))
+
+        # Same log, devices listed the other way round, the lost box stays away
+        connected = [box for box in range(BOXES) if box != LOST_BOX]
+        run_aggregator(aggregator, log, summary, devices[::-1], masters, connected, 1)
+
+        dump = subprocess.run([aggregator, "-d", log], check=True, capture_output=True, text=True).stdout
+        records = list(csv.DictReader(io.StringIO(dump)))
+        expect(len(records) == 2 * (BOXES + len(connected)),
+               "expected %d log records, got %d" % (2 * (BOXES + len(connected)), len(records)))
+        for record in records:
+            expect(record["box"] in devices, "unknown box %s" % record["box"])
+            box = devices.index(record["box"])
+            if record["zone"] == "0":
+                expect(float(record["humidity"]) * 10 in (humidity(box, 0), humidity(box, 1)),
+                       "reading of %s logged under %s" % (record["humidity"], record["box"]))
+                expect(record["faults"] == ("2" if box == FAULTY_BOX else "0"), "faults of %s" % record["box"])
+            else:
+                expect(record["interval_ms"] == "20000", "interval of %s" % record["box"])
+
+    print("OK: %d boxes, summary and log as expected" % BOXES)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,270 @@
+/*
+Runs the benchmark firmware in simavr and collects its results on the host.
+
+The firmware built by the benchmark environment measures its hot paths at boot and prints one JSON line per
+result over the UART. This runner loads that ELF into a simulated ATmega328P at 16 MHz, puts stand-ins for the
+devices on the board on the TWI bus (the SSD1306 acknowledges everything, the DHT20 answers measurements with a
+valid status and CRC, the TCA9548A multiplexer acknowledges channel selects) and writes every JSON line to a file
+until the firmware reports {"benchmark":"done"}.
+
+Build:  g++ -O2 -std=c++17 -I/usr/include/simavr -o drybox-bench tools/simavr/drybox_bench.cpp -lsimavr -lelf
+Usage:  drybox-bench [-v] firmware.elf [output]    (output defaults to bench_output.txt, -v echoes the other
+                                                    serial output to stderr)
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include <avr_twi.h>
+#include <avr_uart.h>
+#include <sim_avr.h>
+#include <sim_elf.h>
+#include <sim_io.h>
+#include <sim_irq.h>
+
+#define MCU "atmega328p"
+#define CPU_FREQUENCY 16000000UL
+#define TIME_LIMIT 120 // Simulated seconds before the run is given up
+
+#define SSD1306_ADDRESS 0x3C
+#define DHT20_ADDRESS 0x38
+#define TCA9548A_ADDRESS 0x70
+
+// What the stand-in DHT20 measures, close to a box that is drying
+#define DHT20_TEMPERATURE 45.0
+#define DHT20_HUMIDITY 30.0
+#define DHT20_STATUS 0x18 // Idle and calibrated
+
+#define BENCHMARK_PREFIX "{\"benchmark\""
+#define BENCHMARK_DONE "{\"benchmark\":\"done\"}"
+
+// All devices of the board behind one TWI connection, the address of a transfer picks the device
+struct Bus
+{
+    avr_irq_t *irq = nullptr; // TWI_IRQ_INPUT towards the AVR, TWI_IRQ_OUTPUT from it
+    uint8_t selected = 0;     // 7 bit address of the device in the current transfer, 0 for none
+    uint8_t written = 0;      // Bytes written in the current transfer
+    uint8_t frame[7];         // DHT20 measurement, handed out by the reads after a trigger
+    bool measured = false;
+    uint8_t readIndex = 0;
+};
+
+struct Uart
+{
+    FILE *output = nullptr;
+    bool verbose = false;
+    bool done = false;
+    unsigned results = 0;
+    std::string line;
+};
+
+static Bus bus;
+static Uart uart;
+
+static uint8_t dht20Crc(const uint8_t *data, uint8_t length)
+{
+    uint8_t crc = 0xFF;
+    while (length--)
+    {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+    }
+    return crc;
+}
+
+static void dht20Measure(Bus &bus)
+{
+    uint32_t humidity = (uint32_t)(DHT20_HUMIDITY / 100.0 * (1UL << 20));
+    uint32_t temperature = (uint32_t)((DHT20_TEMPERATURE + 50) / 200.0 * (1UL << 20));
+
+    bus.frame[0] = DHT20_STATUS;
+    bus.frame[1] = humidity >> 12;
+    bus.frame[2] = humidity >> 4;
+    bus.frame[3] = (humidity & 0x0F) << 4 | temperature >> 16;
+    bus.frame[4] = temperature >> 8;
+    bus.frame[5] = temperature;
+    bus.frame[6] = dht20Crc(bus.frame, 6);
+    bus.measured = true;
+}
+
+static bool present(uint8_t address)
+{
+    return address == SSD1306_ADDRESS || address == DHT20_ADDRESS || address == TCA9548A_ADDRESS;
+}
+
+static void acknowledge(Bus &bus)
+{
+    avr_raise_irq(bus.irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, bus.selected << 1, 1));
+}
+
+// Every TWI condition the AVR puts on the bus, modelled on simavr's i2c_eeprom part
+static void busHook(avr_irq_t *, uint32_t value, void *param)
+{
+    Bus &bus = *(Bus *)param;
+    avr_twi_msg_irq_t message;
+    message.u.v = value;
+
+    if (message.u.twi.msg & TWI_COND_STOP)
+        bus.selected = 0;
+
+    if (message.u.twi.msg & TWI_COND_START)
+    {
+        uint8_t address = message.u.twi.addr >> 1;
+        bus.selected = present(address) ? address : 0; // Nobody acknowledges an absent device
+        bus.written = 0;
+        bus.readIndex = 0;
+        if (bus.selected)
+            acknowledge(bus);
+    }
+
+    if (!bus.selected)
+        return;
+
+    if (message.u.twi.msg & TWI_COND_WRITE)
+    {
+        // 0xAC 0x33 0x00 triggers a DHT20 measurement, the result is ready long before the firmware reads it
+        if (bus.selected == DHT20_ADDRESS && bus.written == 0 && message.u.twi.data == 0xAC)
+            dht20Measure(bus);
+        bus.written++;
+        acknowledge(bus);
+    }
+
+    if (message.u.twi.msg & TWI_COND_READ)
+    {
+        uint8_t data = 0xFF;
+        if (bus.selected == DHT20_ADDRESS)
+        {
+            if (!bus.measured)
+                data = DHT20_STATUS; // Status reads, e.g. while the library initialises the sensor
+            else if (bus.readIndex < sizeof(bus.frame))
+                data = bus.frame[bus.readIndex++];
+        }
+        avr_raise_irq(bus.irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_READ, bus.selected << 1, data));
+    }
+}
+
+static void attachBus(avr_t *avr, Bus &bus)
+{
+    static const char *names[2] = {"8>drybox.bus.out", "32<drybox.bus.in"}; // TWI_IRQ_INPUT, TWI_IRQ_OUTPUT
+    bus.irq = avr_alloc_irq(&avr->irq_pool, 0, 2, names);
+    avr_irq_register_notify(bus.irq + TWI_IRQ_OUTPUT, busHook, &bus);
+
+    avr_connect_irq(bus.irq + TWI_IRQ_INPUT, avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+    avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), bus.irq + TWI_IRQ_OUTPUT);
+}
+
+static void handleLine(Uart &uart)
+{
+    if (uart.line.compare(0, strlen(BENCHMARK_PREFIX), BENCHMARK_PREFIX) != 0)
+    {
+        if (uart.verbose)
+            fprintf(stderr, "%s\n", uart.line.c_str());
+        return;
+    }
+
+    fprintf(uart.output, "%s\n", uart.line.c_str());
+    if (uart.line == BENCHMARK_DONE)
+        uart.done = true;
+    else
+        uart.results++;
+}
+
+static void uartHook(avr_irq_t *, uint32_t value, void *param)
+{
+    Uart &uart = *(Uart *)param;
+    char c = (char)value;
+
+    if (c == '\n')
+    {
+        handleLine(uart);
+        uart.line.clear();
+    }
+    else if (c != '\r')
+    {
+        uart.line += c;
+    }
+}
+
+static void attachUart(avr_t *avr, Uart &uart)
+{
+    // Keep simavr from printing the UART output itself, the hook decides where it goes
+    uint32_t flags = 0;
+    avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+    flags &= ~AVR_UART_FLAG_STDIO;
+    avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), uartHook, &uart);
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-v] firmware.elf [output]\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    int arg = 1;
+    if (arg < argc && strcmp(argv[arg], "-v") == 0)
+    {
+        uart.verbose = true;
+        arg++;
+    }
+    if (arg >= argc || argc - arg > 2)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    const char *firmwarePath = argv[arg];
+    const char *outputPath = arg + 1 < argc ? argv[arg + 1] : "bench_output.txt";
+
+    elf_firmware_t firmware;
+    memset(&firmware, 0, sizeof(firmware));
+    if (elf_read_firmware(firmwarePath, &firmware) != 0)
+    {
+        fprintf(stderr, "cannot read %s\n", firmwarePath);
+        return 1;
+    }
+
+    avr_t *avr = avr_make_mcu_by_name(MCU);
+    if (!avr)
+    {
+        fprintf(stderr, "simavr does not know the %s\n", MCU);
+        return 1;
+    }
+    avr_init(avr);
+    firmware.frequency = CPU_FREQUENCY; // The Arduino ELF does not carry it
+    avr_load_firmware(avr, &firmware);
+
+    uart.output = fopen(outputPath, "w");
+    if (!uart.output)
+    {
+        perror(outputPath);
+        return 1;
+    }
+    attachBus(avr, bus);
+    attachUart(avr, uart);
+
+    int state = cpu_Running;
+    while (!uart.done && state != cpu_Done && state != cpu_Crashed)
+    {
+        state = avr_run(avr);
+        if (avr->cycle > (avr_cycle_count_t)TIME_LIMIT * CPU_FREQUENCY)
+            break;
+    }
+    fclose(uart.output);
+
+    if (!uart.done)
+    {
+        fprintf(stderr, "firmware %s before the benchmarks finished\n",
+                state == cpu_Crashed ? "crashed" : (state == cpu_Done ? "stopped" : "timed out"));
+        return 1;
+    }
+    fprintf(stderr, "%u results written to %s after %.2f simulated seconds\n", uart.results, outputPath,
+            (double)avr->cycle / CPU_FREQUENCY);
+    return 0;
+}